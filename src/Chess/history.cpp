@@ -0,0 +1,130 @@
+/*
+  Stockfish, a chess program for iOS.
+  Copyright (C) 2004-2014 Tord Romstad, Marco Costalba, Joona Kiiski.
+
+  Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+////
+//// Includes
+////
+
+#include <cassert>
+#include <cstring>
+
+#include "history.h"
+
+namespace Chess {
+
+////
+//// Functions
+////
+
+/// Constructor
+
+History::History() {
+  this->clear();
+}
+
+
+/// History::clear() clears the history tables.
+
+void History::clear() {
+  memset(history, 0, 2 * 64 * 64 * sizeof(int));
+  for(int p = 0; p < 16; p++)
+    for(int s = 0; s < 64; s++)
+      counterMoves[p][s] = MOVE_NONE;
+}
+
+
+/// History::success() registers a move as being successful.  This is done
+/// whenever a non-capturing move causes a beta cutoff in the main search.
+/// The move is rewarded by the square of the remaining depth, so that cutoffs
+/// close to the root count much more than cutoffs close to the leaves.
+
+void History::success(Color c, Move m, Depth d) {
+  assert(c == WHITE || c == BLACK);
+  assert(move_is_ok(m));
+
+  int &h = history[c][move_from(m)][move_to(m)];
+  h += int(d) * int(d);
+
+  // Prevent history overflow
+  if(h >= HistoryMax)
+    this->age();
+}
+
+
+/// History::failure() registers a move as being unsuccessful.  The function
+/// is called for each non-capturing move which was searched before the move
+/// causing a beta cutoff.
+
+void History::failure(Color c, Move m, Depth d) {
+  assert(c == WHITE || c == BLACK);
+  assert(move_is_ok(m));
+
+  int &h = history[c][move_from(m)][move_to(m)];
+  h -= int(d) * int(d);
+
+  // Prevent history overflow
+  if(h <= -HistoryMax)
+    this->age();
+}
+
+
+/// History::move_ordering_score() returns an integer value used to order the
+/// non-capturing moves in the MovePicker class.
+
+int History::move_ordering_score(Color c, Move m) const {
+  assert(c == WHITE || c == BLACK);
+  assert(move_is_ok(m));
+
+  return history[c][move_from(m)][move_to(m)];
+}
+
+
+/// History::set_counter_move() remembers a quiet move which caused a beta
+/// cutoff in reply to a move of the piece p to the square to.
+
+void History::set_counter_move(Piece p, Square to, Move m) {
+  assert(piece_is_ok(p));
+  assert(square_is_ok(to));
+
+  counterMoves[p][to] = m;
+}
+
+
+/// History::counter_move() returns the last quiet move which refuted a move
+/// of the piece p to the square to, or MOVE_NONE if there is none.
+
+Move History::counter_move(Piece p, Square to) const {
+  assert(piece_is_ok(p));
+  assert(square_is_ok(to));
+
+  return counterMoves[p][to];
+}
+
+
+/// History::age() divides all entries of the history table by 2.
+
+void History::age() {
+  for(int c = 0; c < 2; c++)
+    for(int from = 0; from < 64; from++)
+      for(int to = 0; to < 64; to++)
+        history[c][from][to] /= 2;
+}
+
+}
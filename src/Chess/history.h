@@ -0,0 +1,87 @@
+/*
+  Stockfish, a chess program for iOS.
+  Copyright (C) 2004-2014 Tord Romstad, Marco Costalba, Joona Kiiski.
+
+  Stockfish is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Stockfish is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#if !defined(HISTORY_H_INCLUDED)
+#define HISTORY_H_INCLUDED
+
+////
+//// Includes
+////
+
+#include "color.h"
+#include "depth.h"
+#include "move.h"
+#include "piece.h"
+#include "square.h"
+
+namespace Chess {
+
+////
+//// Types
+////
+
+/// The History class stores statistics about how often quiet moves have
+/// caused a beta cutoff during the current search.  The history table is
+/// indexed by the side to move and the from and to squares of the move (a
+/// "butterfly" table).  The class also remembers, for every piece and
+/// destination square, the last quiet move which refuted a move of that
+/// piece to that square (the "counter move").  Both are used for ordering
+/// non-captures in MovePicker.
+
+class History {
+
+public:
+  History();
+  void clear();
+  void success(Color c, Move m, Depth d);
+  void failure(Color c, Move m, Depth d);
+  int move_ordering_score(Color c, Move m) const;
+  void set_counter_move(Piece p, Square to, Move m);
+  Move counter_move(Piece p, Square to) const;
+
+private:
+  void age();
+
+  int history[2][64][64];  // [color][from][to]
+  Move counterMoves[16][64];  // [piece][to]
+};
+
+
+////
+//// Constants and variables
+////
+
+/// HistoryMax controls how often the history counters will be scaled down:
+/// When the history score for a move gets bigger than HistoryMax, all
+/// entries in the table are divided by 2.  It is difficult to guess what
+/// the ideal value of this constant is.  Scaling down the scores often has
+/// the effect that parts of the search tree which have been searched
+/// recently have a bigger importance for move ordering than the moves which
+/// have been searched a long time ago.
+///
+/// Note that HistoryMax should probably be changed whenever the constant
+/// OnePly in depth.h is changed.  This is somewhat annoying.  Perhaps it
+/// would be better to scale down the history table at regular intervals?
+
+const int HistoryMax = 50000 * OnePly;
+
+}
+
+#endif // !defined(HISTORY_H_INCLUDED)
@@ -23,7 +23,7 @@
 
 #include <cassert>
 
-//#include "history.h"
+#include "history.h"
 #include "movegen.h"
 #include "movepick.h"
 #include "value.h"
@@ -43,8 +43,8 @@ namespace {
     PH_MATE_KILLER,    // Mate killer from the current ply
     PH_GOOD_CAPTURES,  // Queen promotions and captures with SEE values >= 0
     PH_BAD_CAPTURES,   // Queen promotions and captures with SEE valuse <= 0
-    PH_KILLER_1,       // Killer move 1 from the current ply (not used yet).
-    PH_KILLER_2,       // Killer move 2 from the current ply (not used yet).
+    PH_KILLER_1,       // Killer move 1 from the current ply
+    PH_KILLER_2,       // Killer move 2 from the current ply
     PH_NONCAPTURES,    // Non-captures and underpromotions
     PH_EVASIONS,       // Check evasions
     PH_QCAPTURES,      // Captures in quiescence search
@@ -74,16 +74,21 @@ namespace {
 /// to help it to return the presumably good moves first, to decide which
 /// moves to return (in the quiescence search, for instance, we only want to
 /// search captures, promotions and some checks) and about how important good
-/// move ordering is at the current node.
+/// move ordering is at the current node.  Non-captures are ordered by the
+/// history table h, if any, with the counter move cm to the previous move
+/// first.
 
 MovePicker::MovePicker(Position &p, bool pvnode, Move ttm, Move mk,
-                       Move k1, Move k2, Depth dpth) {
+                       Move k1, Move k2, Depth dpth, const History *h,
+                       Move cm) {
   pos = &p;
+  history = h;
+  counterMove = cm;
   pvNode = pvnode;
   ttMove = ttm;
   mateKiller = (mk == ttm)? MOVE_NONE : mk;
-  killer1 = k1;
-  killer2 = k2;
+  killer1 = (k1 == ttm || k1 == mk)? MOVE_NONE : k1;
+  killer2 = (k2 == ttm || k2 == mk || k2 == k1)? MOVE_NONE : k2;
   depth = dpth;
   movesPicked = 0;
   numOfMoves = 0;
@@ -147,6 +152,24 @@ Move MovePicker::get_next_move() {
       }
       break;
 
+    case PH_KILLER_1:
+    case PH_KILLER_2: {
+      // Killers are quiet moves.  A killer which is a capture in this
+      // position is picked with the captures instead, and queen promotions
+      // are generated together with the captures.
+      Move k = (PhaseTable[phaseIndex] == PH_KILLER_1)? killer1 : killer2;
+      if(k != MOVE_NONE && !pos->move_is_capture(k) &&
+         move_promotion(k) != QUEEN) {
+        assert(move_is_ok(k));
+        Move m = generate_move_if_legal(*pos, k, pinned);
+        if(m != MOVE_NONE) {
+          assert(m == k);
+          return m;
+        }
+      }
+      break;
+    }
+
     case PH_GOOD_CAPTURES:
       // pinned = pos->pinned_pieces(pos->side_to_move());
       numOfMoves = generate_captures(*pos, moves);
@@ -262,8 +285,16 @@ void MovePicker::score_captures() {
 }
 
 void MovePicker::score_noncaptures() {
-  for(int i = 0; i < numOfMoves; i++)
-    moves[i].score = 0;
+  // Non-captures are ordered by their history scores.  The counter move is
+  // placed above all of them, since it refuted the same move of the
+  // opponent elsewhere in the tree.
+  Color us = pos->side_to_move();
+  for(int i = 0; i < numOfMoves; i++) {
+    Move m = moves[i].move;
+    moves[i].score = history? history->move_ordering_score(us, m) : 0;
+    if(m == counterMove)
+      moves[i].score += 2 * HistoryMax;
+  }
 }
 
 void MovePicker::score_evasions() {
@@ -357,6 +388,7 @@ Move MovePicker::pick_move_from_list() {
         moves[bestIndex] = tmp;
         move = moves[movesPicked++].move;
         if(move != ttMove && move != mateKiller &&
+           move != killer1 && move != killer2 &&
            pos->move_is_legal(move, pinned))
           return move;
       }
@@ -457,14 +489,18 @@ Move MovePicker::pick_move_from_list() {
 void MovePicker::init_phase_table() {
   int i = 0;
 
+  // Every phase index points at the entry before the first phase, which
+  // must be a PH_STOP entry so that nothing is picked before the first
+  // phase has started.  The main search has none before it:
+  PhaseTable[i++] = PH_STOP;
+
   // Main search
   MainSearchPhaseIndex = i - 1;
   PhaseTable[i++] = PH_TT_MOVE;
   PhaseTable[i++] = PH_MATE_KILLER;
   PhaseTable[i++] = PH_GOOD_CAPTURES;
-  // PH_KILLER_1 and PH_KILLER_2 are not yet used.
-  // PhaseTable[i++] = PH_KILLER_1;
-  // PhaseTable[i++] = PH_KILLER_2;
+  PhaseTable[i++] = PH_KILLER_1;
+  PhaseTable[i++] = PH_KILLER_2;
   PhaseTable[i++] = PH_NONCAPTURES;
   PhaseTable[i++] = PH_BAD_CAPTURES;
   PhaseTable[i++] = PH_STOP;
@@ -24,7 +24,10 @@
 //// Includes
 ////
 
+#include <cassert>
+
 #include "depth.h"
+#include "history.h"
 #include "lock.h"
 #include "position.h"
 
@@ -46,12 +49,13 @@ class MovePicker {
 
 public:
   MovePicker(Position &p, bool pvnode, Move ttm, Move mk, Move k1, Move k2,
-             Depth dpth);
+             Depth dpth, const History *h = NULL, Move cm = MOVE_NONE);
   Move get_next_move();
   Move get_next_move(Lock &lock);
   int number_of_moves() const;
   int current_move_score() const;
   Bitboard discovered_check_candidates();
+  void attach(Position &p, const History *h);
 
   static void init_phase_table();
 
@@ -63,7 +67,8 @@ private:
   Move pick_move_from_list();
 
   Position *pos;
-  Move ttMove, mateKiller, killer1, killer2;
+  const History *history;
+  Move ttMove, mateKiller, killer1, killer2, counterMove;
   Bitboard pinned, dc;
   MoveStack moves[256], badCaptures[64];
   bool pvNode;
@@ -87,6 +92,19 @@ inline Bitboard MovePicker::discovered_check_candidates() {
   return dc;
 }
 
+
+/// MovePicker::attach() makes the move picker continue picking moves for a
+/// copy of the position it was created with, ordering the non-captures with
+/// the history table h.  This is used when several threads share the
+/// remaining moves of a node, since the thread which owns the original
+/// position and history table keeps changing them while searching.
+
+inline void MovePicker::attach(Position &p, const History *h) {
+  assert(p.get_key() == pos->get_key());
+  pos = &p;
+  history = h;
+}
+
 }
 
 #endif // !defined(MOVEPICK_H_INCLUDED)
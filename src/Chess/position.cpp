@@ -1930,18 +1930,60 @@ bool Position::is_mate() {
 }
 
 
-/// Position::is_draw() tests whether the position is drawn by material,
-/// repetition, or the 50 moves rule.  It does not detect stalemates, this
-/// must be done by the search.
+/// Position::has_any_legal_move() tests whether the side to move has at
+/// least one legal move.  It is much cheaper than generating all legal
+/// moves, because it stops as soon as a legal move is found.  King moves
+/// are tried first, since the king can usually step somewhere, and are
+/// tested with the king removed from the board so that a square behind the
+/// king on the line of a checking slider is not mistaken for a safe one.
+
+bool Position::has_any_legal_move() const {
+  Color us = this->side_to_move(), them = opposite_color(us);
+  Square ksq = this->king_square(us);
+  Bitboard occ = this->occupied_squares();
+  Bitboard b;
 
-bool Position::is_draw() const {
-  // Draw by material?
-	if (!this->pawns() &&
-		this->non_pawn_material(WHITE) + this->non_pawn_material(BLACK)
-		<= BishopValueMidgame) {
-		return true;
-	}
+  clear_bit(&occ, ksq);
+  b = this->king_attacks(ksq) & ~this->pieces_of_color(us);
+  while(b) {
+    Square s = pop_1st_bit(&b);
+    if(!(this->pawn_attacks(us, s) & this->pawns(them)) &&
+       !(this->knight_attacks(s) & this->knights(them)) &&
+       !(this->king_attacks(s) & this->kings(them)) &&
+       !(rook_attacks_bb(s, occ) & this->rooks_and_queens(them)) &&
+       !(bishop_attacks_bb(s, occ) & this->bishops_and_queens(them)))
+      return true;
+  }
+
+  MoveStack mlist[256];
+  int i, n;
+
+  // The evasion generator only generates legal moves:
+  if(this->is_check())
+    return generate_evasions(*this, mlist) > 0;
 
+  // No king move was legal, so only moves by other pieces remain:
+  Bitboard pinned = this->pinned_pieces(us);
+  n = generate_captures(*this, mlist);
+  for(i = 0; i < n; i++)
+    if(move_from(mlist[i].move) != ksq
+       && this->move_is_legal(mlist[i].move, pinned))
+      return true;
+  n = generate_noncaptures(*this, mlist);
+  for(i = 0; i < n; i++)
+    if(move_from(mlist[i].move) != ksq
+       && this->move_is_legal(mlist[i].move, pinned))
+      return true;
+  return false;
+}
+
+
+/// Position::is_draw() tests whether the position is drawn by repetition or
+/// the 50 moves rule.  It does not detect stalemates, this must be done by
+/// the search, nor draws by insufficient material, which are recognized by
+/// the evaluation.
+
+bool Position::is_draw() const {
   // Draw by the 50 moves rule?
   if(rule50 > 100 || (rule50 == 100 && !this->is_check()))
     return true;
@@ -2072,10 +2114,21 @@ void Position::init_zobrist() {
 /// and changing the sign of the corresponding white scores.
 
 void Position::init_piece_square_tables() {
+  init_piece_square_tables(MgPST, EgPST);
+}
+
+
+/// Position::init_piece_square_tables() with arguments initializes the piece
+/// square tables from the white halves given by the caller, indexed by piece
+/// and square.  This lets an evaluation keep its own material and square
+/// scores up to date through do_move and undo_move.  Positions set up before
+/// the call keep their old incremental scores.
+
+void Position::init_piece_square_tables(const int mgPst[][64], const int egPst[][64]) {
   for(Square s = SQ_A1; s <= SQ_H8; s++) {
     for(Piece p = WP; p <= WK; p++) {
-      MgPieceSquareTable[p][s] = Value(MgPST[p][s]);
-      EgPieceSquareTable[p][s] = Value(EgPST[p][s]);
+      MgPieceSquareTable[p][s] = Value(mgPst[p][s]);
+      EgPieceSquareTable[p][s] = Value(egPst[p][s]);
     }
   }
   for(Square s = SQ_A1; s <= SQ_H8; s++)
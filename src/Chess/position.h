@@ -287,6 +287,7 @@ public:
 
   // Game termination checks
   bool is_mate();
+  bool has_any_legal_move() const;
   bool is_draw() const;
   DrawReason is_immediate_draw() const;
 
@@ -316,6 +317,7 @@ public:
   // Static member functions:
   static void init_zobrist();
   static void init_piece_square_tables();
+  static void init_piece_square_tables(const int mgPst[][64], const int egPst[][64]);
   static bool is_valid_fen(const std::string &str);
 private:
   // Initialization helper functions (used while setting up a position)
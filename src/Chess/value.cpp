@@ -37,9 +37,9 @@ namespace Chess {
 /// The function is called before storing a value to the transposition table.
 
 Value value_to_tt(Value v, int ply) {
-  if(v >= value_mate_in(100))
+  if(v >= value_mate_in(MaxPly))
     return v + ply;
-  else if(v <= value_mated_in(100))
+  else if(v <= value_mated_in(MaxPly))
     return v - ply;
   else
     return v;
@@ -51,9 +51,9 @@ Value value_to_tt(Value v, int ply) {
 /// ply depth.
 
 Value value_from_tt(Value v, int ply) {
-  if(v >= value_mate_in(100))
+  if(v >= value_mate_in(MaxPly))
     return v - ply;
-  else if(v <= value_mated_in(100))
+  else if(v <= value_mated_in(MaxPly))
     return v + ply;
   else
     return v;
@@ -95,6 +95,11 @@ const Value PieceValueEndgame[17] = {
 const Value TempoValueMidgame = Value(50);
 const Value TempoValueEndgame = Value(20);
 
+/// Maximum number of plies searched from the root.  Every score within
+/// MaxPly of VALUE_MATE is a mate score, counted in plies from the root.
+
+const int MaxPly = 128;
+
 
 ////
 //// Inline functions
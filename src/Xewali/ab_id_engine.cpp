@@ -4,26 +4,77 @@
 */
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <ctime>
-#include <set>
-#include <map>
-#include <fstream>
-#include <ctime>
+#include <iostream>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <sstream>
+#include <thread>
+#include "Chess/history.h"
+#include "Chess/lock.h"
 #include "Chess/mersenne.h"
+#include "Chess/misc.h"
 #include "Chess/movepick.h"
 #include "Xewali/ab_id_engine.h"
+#include "Xewali/eval_cache.h"
+#include "Xewali/time_manager.h"
+#include "Xewali/transposition.h"
 
 namespace AbIterDeepEngine
 {
+	// positions evaluated during the search, kept for the whole game
+	Transposition::Table transposition_table;
+
+	// decides when the search is stopped
+	TimeManagement::TimeManager time_manager;
+
+	// time in ms kept in reserve per move for the communication with the GUI
+	int move_overhead = TimeManagement::DefaultMoveOverhead;
+
+	// registration of split points and of threads joining them
+	Lock split_lock;
+
+	// depth reductions of late moves, indexed by remaining depth and move number
+	int reductions[64][64];
+
 	void init()
 	{
 		init_mersenne();
 		init_direction_table();
 		init_bitboards();
 		Position::init_zobrist();
-		Position::init_piece_square_tables();
+		Evaluation::init();
 		MovePicker::init_phase_table();
+		lock_init(&split_lock, NULL);
+		set_threads(1);
+
+		// the reduction grows with the logarithms of both the depth and the move number
+		for (int depth = 1; depth < 64; depth++)
+		{
+			for (int move_count = 1; move_count < 64; move_count++)
+			{
+				reductions[depth][move_count] = int(0.5 + std::log(double(depth)) * std::log(double(move_count)) / 2.0);
+			}
+		}
+	}
+
+	void set_hash_size(std::size_t mb)
+	{
+		transposition_table.resize(mb);
+	}
+
+	void set_move_overhead(int ms)
+	{
+		move_overhead = (std::max)(ms, 0);
+	}
+
+	void new_game()
+	{
+		transposition_table.clear();
 	}
 
 	void set_position(Position& pos, const std::string & fen, const std::vector<std::string>& moves)
@@ -38,264 +89,1685 @@ namespace AbIterDeepEngine
 		}
 	}
 
-	struct MoveNode;
+	/// Maximum number of legal moves in any position
+	constexpr int MaxMoves = 256;
+
+	/// Minimum remaining depth of a node to be shared between threads (YBWC)
+	constexpr int MinSplitDepth = 4;
+
+	/// Maximum number of nested split points a thread can be master of
+	constexpr int MaxSplitPoints = 8;
+
+	/// A capture whose gain falls short of alpha by more than this is not searched
+	/// in the quiescence search (delta pruning)
+	constexpr int DeltaMargin = 200;
+
+	/// Maximum number of quiet moves per node penalized in the history table on a cutoff
+	constexpr int MaxQuietsSearched = 64;
+
+	/// Minimum remaining depth for a null move search
+	constexpr int NullMoveDepth = 2;
+
+	/// Minimum remaining depth at which a null move cutoff is verified by a reduced search
+	constexpr int NullVerificationDepth = 8;
+
+	/// Minimum remaining depth for reducing late moves
+	constexpr int ReductionDepth = 3;
+
+	/// Maximum remaining depth for futility pruning, and the margin per ply in centipawns
+	constexpr int FutilityDepth = 3;
+	constexpr int FutilityMargin = 150;
+
+	/// Maximum remaining depth for razoring, and the margin per ply in centipawns
+	constexpr int RazorDepth = 3;
+	constexpr int RazorMargin = 250;
+
+	/// Maximum remaining depth for late move pruning
+	constexpr int LateMovePruningDepth = 3;
+
+	/// Iterations from which the root is searched with an aspiration window
+	constexpr int AspirationDepth = 4;
+
+	/// Initial half width of the aspiration window in centipawns
+	constexpr int AspirationWindow = 25;
 
-	struct MoveNode
+	/// Number of nodes searched between two looks at the clock
+	constexpr uint64_t TimeCheckInterval = 1024;
+
+	/// Ordering scores
+	constexpr int HashMoveScore = 1 << 30;
+	constexpr int CaptureScore = 1 << 20;
+	constexpr int KillerScore = 1 << 19;
+
+	/// A frame of the search stack. One frame is used per ply, so that the
+	/// search itself never allocates memory.
+	struct SearchStack
+	{
+		// the ordered list of legal moves, only generated at the root
+		Move moves[MaxMoves];
+		int scores[MaxMoves];
+		int move_count = 0;
+		int next_index = 0;
+
+		// generates the moves of every other node in stages
+		MovePicker* picker = nullptr;
+
+		// the move being searched from this ply
+		Move current_move = MOVE_NONE;
+
+		// quiet moves which caused a cutoff at this ply
+		Move killers[2] = { MOVE_NONE, MOVE_NONE };
+
+		// the last move found to mate from this ply
+		Move mate_killer = MOVE_NONE;
+
+		// the principal variation starting at this ply
+		Move pv[MaxPly];
+		int pv_length = 0;
+	};
+
+	/// A principal variation from the root, with its evaluation from the side to
+	/// move's point of view
+	struct RootLine
 	{
-		Move move = Move::MOVE_NONE;
-		double eval = 0.;
-		std::vector<std::shared_ptr<MoveNode>> order_next;
-		std::set<Move> keys_next;
+		Value eval = VALUE_DRAW;
+		Move pv[MaxPly];
+		int pv_length = 0;
 	};
 
-	void print_tree(std::shared_ptr<MoveNode> move_node, const std::string& old, int& count, std::ofstream& file)
+	struct SearchThread;
+
+	/// A node whose remaining moves are searched by several threads (young brothers
+	/// wait concept). The eldest brother is always searched by the master alone, the
+	/// younger brothers are then picked from the master's move list or move picker by
+	/// every thread working at the split point. Fields after the lock are guarded by it.
+	struct SplitPoint
 	{
-		std::string pre = "";
-		if (move_node->move != MOVE_NONE && std::abs(move_node->eval) < 2)
+		SplitPoint()
 		{
-			pre = old + " " + move_to_string(move_node->move);
-			file << pre << "[" << move_node->eval << "]\n";
-			count++;
+			lock_init(&lock, NULL);
 		}
-		for (std::size_t i = 0; i < move_node->order_next.size(); i++)
+
+		~SplitPoint()
 		{
-			print_tree(move_node->order_next[i], pre, count, file);
+			lock_destroy(&lock);
 		}
-	}
 
-	void populate_next_moves(std::shared_ptr<MoveNode> node, Position& pos, bool only_captures)
+		SplitPoint* parent = nullptr;
+		SearchThread* master = nullptr;
+		Position pos;
+		SearchStack* ss = nullptr;
+		int ply = 0;
+		int depth = 0;
+
+		// the master's search stack around the split point, copied to the stack of
+		// every thread joining it
+		Move previous_move = MOVE_NONE;
+		Move killers[2] = { MOVE_NONE, MOVE_NONE };
+		Move mate_killer = MOVE_NONE;
+
+		// the master keeps updating its history table, the move picker shared by the
+		// threads orders the remaining quiet moves with this copy
+		History history;
+
+		// guarded by split_lock
+		bool active = false;
+		int slaves = 0;
+
+		// set once a move fails high, all threads at the split point and below stop
+		std::atomic<bool> cutoff{ false };
+
+		Lock lock;
+		bool exhausted = false;
+		Value alpha = VALUE_DRAW;
+		Value beta = VALUE_DRAW;
+		Value best_eval = VALUE_DRAW;
+		Move best_move = MOVE_NONE;
+		Move pv[MaxPly];
+		int pv_length = 0;
+	};
+
+	/// The state of one search thread. Every thread searches its own copy of the
+	/// position with its own search stack, only the transposition table is shared.
+	/// Thread 0 is the main thread, it runs in the caller of play_move and
+	/// decides when the search ends.
+	struct SearchThread
 	{
-		bool is_root_move_capture = false;
-		UndoInfo u;
-		if (node->move != MOVE_NONE)
-		{
-			is_root_move_capture = pos.move_is_capture(node->move);
-			pos.do_move(node->move, u);
-		}
+		int id = 0;
+		Position pos;
+		SearchStack stack[MaxPly];
+		// written by the thread only, read by the main thread for reporting
+		std::atomic<uint64_t> nodes{ 0 };
+		int transpositions = 0;
 
-		Move move_list[256];
-		int num_legal_moves = pos.all_legal_moves(move_list);
-		bool white_to_move = pos.side_to_move() == Color::WHITE;
-		for (std::size_t i = 0; i < num_legal_moves; i++)
-		{
-			const auto& move = move_list[i];
+		// the highest ply reached in the current search
+		int sel_depth = 0;
 
-			if (node->keys_next.find(move) != node->keys_next.end())
-			{
-				// move already exists
-				continue;
-			}
+		// result of the last completed iteration
+		int completed_depth = 0;
+		Move best_move = MOVE_NONE;
+		Move ponder_move = MOVE_NONE;
+		Value best_eval = VALUE_DRAW;
+
+		// multi PV : the best root moves of the last iteration, best first. The root
+		// search for line pv_index skips the moves of the lines before it.
+		RootLine root_lines[MaxMultiPV];
+		int pv_count = 1;
+		int pv_index = 0;
+
+		// quiet move ordering statistics of the thread's own search
+		History history;
+
+		// pawn structures and material signatures evaluated by the thread, kept between searches
+		Pawns::Table pawn_table;
+		Material::Table material_table;
+
+		// static evaluations of the positions the thread has seen
+		EvalCache::Table eval_cache;
+
+		// split points this thread is master of, guarded by split_lock
+		SplitPoint split_points[MaxSplitPoints];
+		int split_count = 0;
 
-			// If only captures need to be taken
-			// 1. first move should be a capture
-			// 2. second move should be capture at the same square
-			if (only_captures && !(is_root_move_capture && move_to(node->move) == move_to(move)))
+		// the innermost split point the thread is working at
+		SplitPoint* current_split = nullptr;
+	};
+
+	std::vector<std::unique_ptr<SearchThread>> search_threads;
+
+	// set by the main thread to make all threads return from the search
+	std::atomic<bool> stop_search(false);
+
+	// set when the GUI stops the search
+	std::atomic<bool> stop_requested(false);
+
+	// set while the search runs on the opponent's time, until the GUI sends ponderhit
+	std::atomic<bool> pondering(false);
+
+	// runs the search while the command loop keeps reading commands
+	std::thread search_worker;
+
+	// serializes the output of the search and of the command loop
+	std::mutex output_mutex;
+
+	// wall clock time the current search has started at
+	std::chrono::steady_clock::time_point search_start;
+
+	/// Intermediate results are only reported once the search has run this long in ms
+	constexpr int ReportDelay = 1000;
+
+	// number of principal variations searched by the main thread
+	int multi_pv = 1;
+
+	// limits of the current search besides the clock, see SearchLimits
+	uint64_t node_limit = 0;
+	int mate_limit = 0;
+	std::vector<Move> search_moves;
+
+	// how the threads share the search
+	SmpMode smp_mode = SmpMode::LazySMP;
+
+	// selective search techniques in use, indexed by Pruning
+	bool pruning_enabled[4] = { true, true, true, true };
+
+	// number of threads looking for a split point to join
+	std::atomic<int> idle_threads(0);
+
+	void set_threads(int count)
+	{
+		count = (std::max)(1, (std::min)(count, MaxThreads));
+		search_threads.resize(count);
+		for (int i = 0; i < count; i++)
+		{
+			if (!search_threads[i])
 			{
-				// only return captures
-				continue;
+				search_threads[i].reset(new SearchThread());
+				search_threads[i]->id = i;
 			}
+		}
+	}
+
+	void set_smp_mode(SmpMode mode)
+	{
+		smp_mode = mode;
+	}
+
+	void set_multi_pv(int count)
+	{
+		multi_pv = (std::max)(1, (std::min)(count, MaxMultiPV));
+	}
+
+	void set_pruning(Pruning technique, bool enabled)
+	{
+		pruning_enabled[int(technique)] = enabled;
+	}
+
+	bool enabled(Pruning technique)
+	{
+		return pruning_enabled[int(technique)];
+	}
 
-			auto child_ptr = std::make_shared<MoveNode>();
-			child_ptr->move = move;
-			child_ptr->eval = white_to_move ? std::numeric_limits<double>::lowest() : (std::numeric_limits<double>::max)();
-			node->order_next.emplace_back(child_ptr);
-			node->keys_next.insert(move);
+	uint64_t nodes_searched()
+	{
+		uint64_t nodes = 0;
+		for (const auto& thread : search_threads)
+		{
+			nodes += thread->nodes.load(std::memory_order_relaxed);
 		}
+		return nodes;
+	}
 
-		if (node->move != MOVE_NONE)
+	/// The main thread stops the search once the hard time limit or the node limit
+	/// is reached. The first iteration is always completed, so that there is a move to play.
+	void check_time(const SearchThread& thread)
+	{
+		if (thread.id == 0 && thread.completed_depth > 0 && !pondering
+			&& (time_manager.hard_limit_reached() || (node_limit > 0 && nodes_searched() >= node_limit)))
 		{
-			pos.undo_move(node->move, u);
+			stop_search = true;
 		}
 	}
 
-	void order_moves(std::shared_ptr<MoveNode> node, const bool white_to_move)
+	/// Counts a node and looks at the clock every few nodes. Only the thread itself
+	/// writes its node counter, so no atomic increment is needed.
+	void count_node(SearchThread& thread, int ply)
 	{
-		// sort the moves
-		if (white_to_move)
+		const uint64_t nodes = thread.nodes.load(std::memory_order_relaxed) + 1;
+		thread.nodes.store(nodes, std::memory_order_relaxed);
+		thread.sel_depth = (std::max)(thread.sel_depth, ply + 1);
+		if (nodes % TimeCheckInterval == 0)
 		{
-			std::sort(node->order_next.begin(), node->order_next.end(),
-				[](std::shared_ptr<MoveNode> a, std::shared_ptr<MoveNode> b)
-			{
-				return a->eval > b->eval;
-			});
+			check_time(thread);
+		}
+	}
+
+	/// Milliseconds since the search has started
+	int search_time()
+	{
+		return int(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - search_start).count());
+	}
+
+	/// The evaluation as a UCI score, in centipawns or in moves to mate
+	std::string score_to_uci(Value eval)
+	{
+		std::ostringstream score;
+		if (eval >= value_mate_in(MaxPly))
+		{
+			score << "mate " << (VALUE_MATE - eval + 1) / 2;
+		}
+		else if (eval <= value_mated_in(MaxPly))
+		{
+			score << "mate " << -(VALUE_MATE + eval) / 2;
 		}
 		else
 		{
-			std::sort(node->order_next.begin(), node->order_next.end(),
-				[](std::shared_ptr<MoveNode> a, std::shared_ptr<MoveNode> b)
-			{
-				return a->eval < b->eval;
-			});
+			score << "cp " << int(eval);
 		}
+		return score.str();
 	}
 
-	void minimax(std::shared_ptr<MoveNode> node, Position& pos, double alpha, double beta, int depth, std::map<Key, std::pair<int, double> >& transposition_table, int& transpositions)
+	/// Sends a principal variation of a thread to the GUI
+	/// @param[in] pv_index The rank of the variation among the multi PV lines, from 0
+	/// @param[in] bound VALUE_TYPE_EXACT, or the bound an evaluation outside the
+	/// aspiration window is known to be
+	void report(const SearchThread& thread, int depth, int pv_index, Value eval, ValueType bound, const Move* pv, int pv_length)
 	{
-		populate_next_moves(node, pos, depth == 0);
-		UndoInfo u;
+		const int elapsed = search_time();
+		const uint64_t nodes = nodes_searched();
 
-		// make move
-		if (node->move != MOVE_NONE)
+		std::ostringstream info;
+		info << "info depth " << depth
+			<< " seldepth " << thread.sel_depth
+			<< " multipv " << pv_index + 1
+			<< " score " << score_to_uci(eval)
+			<< (bound == VALUE_TYPE_LOWER ? " lowerbound" : bound == VALUE_TYPE_UPPER ? " upperbound" : "")
+			<< " nodes " << nodes
+			<< " nps " << nodes * 1000 / uint64_t((std::max)(elapsed, 1))
+			<< " time " << elapsed
+			<< " hashfull " << transposition_table.hashfull()
+			<< " pv";
+		for (int i = 0; i < pv_length; i++)
 		{
-			pos.do_move(node->move, u);
+			info << " " << move_to_string(pv[i]);
 		}
+		send(info.str());
+	}
 
-		// get the zobrist hash key
-		auto key = pos.get_key();
-		auto table_val = transposition_table.find(key);
+	/// Number of quiet moves searched at a depth before late move pruning starts
+	int late_move_count(int depth)
+	{
+		return 3 + depth * depth;
+	}
 
-		// position should have been seen before and evaluated at an equal or higher depth
-		// if this is the case, the position need not be evaluated again
-		if (table_val != transposition_table.end() && table_val->second.first >= depth)
+	/// A thread stops when the search is stopped or when a split point it works
+	/// at, or any split point above it, has failed high
+	bool thread_should_stop(const SearchThread& thread)
+	{
+		if (stop_search.load(std::memory_order_relaxed))
 		{
-			node->eval = table_val->second.second;
-			transpositions++;
+			return true;
 		}
-		else
+		for (const SplitPoint* sp = thread.current_split; sp; sp = sp->parent)
+		{
+			if (sp->cutoff.load(std::memory_order_relaxed))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void score_moves(const Position& pos, SearchStack* ss, Move hash_move)
+	{
+		for (int i = 0; i < ss->move_count; i++)
 		{
-			// terminal position reached, call static evaluation function
-			if (node->order_next.empty())
+			const Move move = ss->moves[i];
+			if (move == hash_move)
 			{
-				node->eval = Evaluation::eval(pos);
-				// terminal position evaluated
-				transposition_table[pos.get_key()] = std::pair<int, double>(depth, node->eval);
+				ss->scores[i] = HashMoveScore;
+			}
+			else if (pos.move_is_capture(move))
+			{
+				// most valuable victim, least valuable attacker
+				ss->scores[i] = CaptureScore + 8 * int(pos.type_of_piece_on(move_to(move))) - int(pos.type_of_piece_on(move_from(move)));
+			}
+			else if (move == ss->killers[0] || move == ss->killers[1])
+			{
+				ss->scores[i] = move == ss->killers[0] ? KillerScore + 1 : KillerScore;
 			}
 			else
 			{
-				// recurse
-				bool white_to_move = pos.side_to_move() == Color::WHITE;
-				node->eval = white_to_move ? std::numeric_limits<double>::lowest() : (std::numeric_limits<double>::max)();
+				ss->scores[i] = 0;
+			}
+		}
+	}
 
-				for (std::size_t i = 0; i < node->order_next.size(); i++)
-				{
-					const auto move_node = node->order_next[i];
-					minimax(move_node, pos, alpha, beta, (std::max)(depth - 1, 0), transposition_table, transpositions);
-					double eval = move_node->eval;
+	/// Moves the best scored move from index i onwards to index i
+	void pick_move(SearchStack* ss, int i)
+	{
+		int best = i;
+		for (int j = i + 1; j < ss->move_count; j++)
+		{
+			if (ss->scores[j] > ss->scores[best])
+			{
+				best = j;
+			}
+		}
+		std::swap(ss->moves[i], ss->moves[best]);
+		std::swap(ss->scores[i], ss->scores[best]);
+	}
 
-					if (white_to_move)
-					{
-						node->eval = (std::max)(node->eval, eval);
-						alpha = (std::max)(alpha, eval);
-					}
-					else
-					{
-						node->eval = (std::min)(node->eval, eval);
-						beta = (std::min)(beta, eval);
-					}
+	void populate_next_moves(const Position& pos, SearchStack* ss)
+	{
+		ss->move_count = pos.all_legal_moves(ss->moves);
+	}
 
-					if (beta < alpha) // cutoff reached - stop looking at other moves
-					{
-						break;
-					}
-				}
+	/// Whether a root move is among the moves the GUI has asked to search
+	bool is_search_move(Move move)
+	{
+		return search_moves.empty() || std::find(search_moves.begin(), search_moves.end(), move) != search_moves.end();
+	}
+
+	/// Removes the root moves which are not to be searched, and those of the multi PV
+	/// lines already searched in this iteration
+	void filter_root_moves(const SearchThread& thread, SearchStack* ss)
+	{
+		for (int i = 0; i < ss->move_count;)
+		{
+			bool excluded = !is_search_move(ss->moves[i]);
+			for (int line = 0; line < thread.pv_index; line++)
+			{
+				excluded = excluded || thread.root_lines[line].pv[0] == ss->moves[i];
+			}
 
-				// non-terminal position evaluated
-				transposition_table[pos.get_key()] = std::pair<int, double>(depth, node->eval);
-				// order child moves
-				order_moves(node, white_to_move);
+			if (excluded)
+			{
+				ss->moves[i] = ss->moves[--ss->move_count];
+			}
+			else
+			{
+				i++;
 			}
 		}
+	}
 
-		// undo move
-		if (node->move != MOVE_NONE)
+	/// Picks the next move of a node, MOVE_NONE once all moves have been picked
+	Move next_move(SearchStack* ss)
+	{
+		if (ss->picker)
+		{
+			return ss->picker->get_next_move();
+		}
+		if (ss->next_index >= ss->move_count)
 		{
-			pos.undo_move(node->move, u);
+			return MOVE_NONE;
 		}
+		pick_move(ss, ss->next_index);
+		return ss->moves[ss->next_index++];
 	}
 
-	void print_move_sequence(std::shared_ptr<MoveNode> move_node)
+	void update_killers(SearchStack* ss, Move move)
 	{
-		std::cout << "[" << move_node->eval << "] ";
-		while (move_node)
+		if (move != ss->killers[0])
 		{
-			std::cout << move_to_string(move_node->move) << " ";
-			move_node = move_node->order_next.empty() ? nullptr : move_node->order_next[0];
+			ss->killers[1] = ss->killers[0];
+			ss->killers[0] = move;
 		}
-		std::cout << "\n";
 	}
 
-	std::string play_move(Position& pos, double& eval, const Evaluation::Book& book, double time_to_move)
+	/// Square the move before this ply went to, SQ_NONE at the root or after a null move
+	Square previous_square(const SearchStack* ss, int ply)
 	{
-		//std::cout << "Move time is " << time_to_move << "\n";
-		// Try to find a random move from the book
-		std::mt19937 rand_gen(time(NULL));
-		const Key pos_key = pos.get_key();
-		std::vector<Move> book_moves;
-		if (book.find(pos_key) != book.end())
+		if (ply == 0 || (ss - 1)->current_move == MOVE_NONE || (ss - 1)->current_move == MOVE_NULL)
 		{
-			const auto& move_set = book.find(pos_key)->second;
-			book_moves = std::vector<Move>(move_set.begin(), move_set.end());
+			return SQ_NONE;
 		}
+		return move_to((ss - 1)->current_move);
+	}
 
-		// see if there are more than one choices
-		if (book_moves.size() > 1)
+	/// The quiet move which last refuted the previous move
+	Move counter_move(const SearchThread& thread, const SearchStack* ss, int ply)
+	{
+		const Square to = previous_square(ss, ply);
+		if (to == SQ_NONE || thread.pos.square_is_empty(to))
 		{
-			std::uniform_int_distribution<std::size_t> rand_idx(0, book_moves.size() - 1);
-			auto idx = rand_idx(rand_gen);
-			//std::cout << "Choosing random move from " << book_moves.size() << " moves. Move Index [" << idx << "]\n";
-			auto choosen_move = book_moves[idx];
-			return move_to_string(choosen_move);
+			return MOVE_NONE;
 		}
+		return thread.history.counter_move(thread.pos.piece_on(to), to);
+	}
 
-		//std::cout << "Did not find book move..\n";
+	/// Rewards a quiet move which caused a cutoff and penalizes the quiet moves
+	/// searched before it without success
+	void update_quiet_stats(SearchThread& thread, SearchStack* ss, int ply, int depth, Move move, const Move* quiets, int quiet_count)
+	{
+		const Color us = thread.pos.side_to_move();
+		update_killers(ss, move);
+		thread.history.success(us, move, Depth(depth * OnePly));
+		for (int i = 0; i < quiet_count; i++)
+		{
+			thread.history.failure(us, quiets[i], Depth(depth * OnePly));
+		}
 
-		// Iterative Deepening searches the move tree by iteratively increasing 
-		// the depth to a max depth. This may sound counterintuitive, since
-		// we end up evaluating many of the same positions again, but the move ordering 
-		// obtained during previous searches at lower depths can help in pruning 
-		// more branches at higher depths.
+		const Square to = previous_square(ss, ply);
+		if (to != SQ_NONE && !thread.pos.square_is_empty(to))
+		{
+			thread.history.set_counter_move(thread.pos.piece_on(to), to, move);
+		}
+	}
+
+	/// A quiet move neither captures nor promotes
+	bool is_quiet(const Position& pos, Move move)
+	{
+		return !pos.move_is_capture(move) && !move_promotion(move);
+	}
+
+	Value negamax(SearchThread& thread, SearchStack* ss, int ply, Value alpha, Value beta, int depth, bool allow_null = true);
+
+	/// Static evaluation from the side to move's point of view. Checkmate and
+	/// stalemate are not recognized, the search detects them at nodes without moves.
+	/// Draws by repetition and the 50 moves rule depend on the moves played before
+	/// and must be detected by the caller, everything else only on the position, so
+	/// that it can be cached.
+	Value evaluate(SearchThread& thread)
+	{
+		Position& pos = thread.pos;
+
+		Value eval;
+		if (!thread.eval_cache.probe(pos.get_key(), eval))
+		{
+			eval = Evaluation::eval(pos, thread.pawn_table, thread.material_table);
+			thread.eval_cache.store(pos.get_key(), eval);
+		}
+
+		return pos.side_to_move() == Color::WHITE ? eval : -eval;
+	}
+
+	bool is_mate_score(Value eval)
+	{
+		return eval >= value_mate_in(MaxPly) || eval <= value_mated_in(MaxPly);
+	}
+
+	/// Searches captures and queen promotions until the position is quiet, so that
+	/// the static evaluation is never taken in the middle of an exchange. The side
+	/// to move may always stand pat on the static evaluation, unless it is in check,
+	/// in which case all evasions are searched.
+	Value quiescence(SearchThread& thread, SearchStack* ss, int ply, Value alpha, Value beta)
+	{
+		Position& pos = thread.pos;
+		ss->pv_length = 0;
+		count_node(thread, ply);
 
-		clock_t start = std::clock();
+		// a draw by rule stays a draw whatever is captured
+		if (ply > 0 && pos.is_draw())
+		{
+			return VALUE_DRAW;
+		}
 
-		int depth = 1;
-		std::map<Key, std::pair<int, double> > transposition_table;
+		const Value stand_pat = evaluate(thread);
+		if (ply >= MaxPly - 1)
+		{
+			return stand_pat;
+		}
 
-		std::shared_ptr<MoveNode> no_move = std::make_shared<MoveNode>();
+		const bool in_check = pos.is_check();
+		Value best_eval = -VALUE_INFINITE;
 
-		for (depth = 1; ; depth++)
+		if (!in_check)
 		{
-			int transpositions = 0;
-			transposition_table.clear();
-			minimax(no_move, pos, std::numeric_limits<double>::lowest(), (std::numeric_limits<double>::max)(), depth, transposition_table, transpositions);
+			// a stalemated side cannot stand pat
+			if (stand_pat >= beta)
+			{
+				return pos.has_any_legal_move() ? stand_pat : VALUE_DRAW;
+			}
+			best_eval = stand_pat;
+			alpha = (std::max)(alpha, stand_pat);
+		}
+
+		// captures are ordered by most valuable victim and least valuable attacker,
+		// in check all evasions are generated
+		MovePicker picker(pos, false, MOVE_NONE, MOVE_NONE, MOVE_NONE, MOVE_NONE, Depth(-OnePly));
+		UndoInfo u;
+		Move move;
+		int move_count = 0;
 
-			if (!no_move->order_next.empty())
+		while ((move = picker.get_next_move()) != MOVE_NONE)
+		{
+			move_count++;
+			if (!in_check)
 			{
-				// If mate found, no need to evaluate deeper
-				if (std::abs(no_move->order_next[0]->eval) == Evaluation::mateEval)
+				// delta pruning : even winning the captured piece for free cannot
+				// bring the evaluation back into the window
+				int gain = Evaluation::PieceValues[move_is_ep(move) ? PAWN : pos.type_of_piece_on(move_to(move))];
+				if (move_promotion(move))
 				{
-					break;
+					gain += Evaluation::QUEEN_VAL - Evaluation::PAWN_VAL;
+				}
+				if (stand_pat + gain + DeltaMargin <= alpha)
+				{
+					continue;
 				}
 
-				// if there's only one move, no point recursing to higher depths
-				if (no_move->order_next.size() == 1)
+				// captures losing material in the exchange on the square are not searched
+				if (!move_promotion(move) && pos.see(move) < 0)
 				{
-					break;
+					continue;
 				}
 			}
 
-			//std::cout << "---- Search at Depth " << depth << " completed. ----\n";
-			//std::cout << transposition_table.size() << " Positions evaluated\n";
-			//std::cout << transpositions << " Transpositions\n";
+			ss->current_move = move;
+			pos.do_move(move, u);
+			Value eval = -quiescence(thread, ss + 1, ply + 1, -beta, -alpha);
+			pos.undo_move(move, u);
 
-			// do not search at higher depths if more than a second has elapsed
-			if ((std::clock() - start) / (double)CLOCKS_PER_SEC > time_to_move)
+			if (thread_should_stop(thread))
 			{
-				break;
+				return VALUE_DRAW;
+			}
+
+			if (eval > best_eval)
+			{
+				best_eval = eval;
+				ss->pv[0] = move;
+				std::copy((ss + 1)->pv, (ss + 1)->pv + (ss + 1)->pv_length, ss->pv + 1);
+				ss->pv_length = (ss + 1)->pv_length + 1;
+
+				if (eval > alpha)
+				{
+					alpha = eval;
+					if (alpha >= beta)
+					{
+						break;
+					}
+				}
 			}
 		}
 
-		/*for (const auto next_move_ptr : no_move->order_next)
+		// in check and no evasion, the side to move is checkmated
+		if (in_check && best_eval == -VALUE_INFINITE)
 		{
-			std::cout << "Eval of move [" << move_to_string(next_move_ptr->move) << "] is {" << next_move_ptr->eval << "}\n";
-		}*/
+			return value_mated_in(ply);
+		}
 
-		if (no_move->order_next.empty())
+		// no capture either, the side to move may be stalemated
+		if (!in_check && move_count == 0 && !pos.has_any_legal_move())
 		{
-			eval = 0.;
-			return "";
+			return VALUE_DRAW;
+		}
+
+		return best_eval;
+	}
+
+	/// Picks the next move of a split point, MOVE_NONE once all moves have been
+	/// picked or a move has failed high. The move picker of a node takes the split
+	/// point lock itself, the move list of the root is picked under the lock.
+	Move next_split_move(SplitPoint* sp)
+	{
+		if (sp->cutoff)
+		{
+			return MOVE_NONE;
 		}
+		if (sp->ss->picker)
+		{
+			return sp->ss->picker->get_next_move(sp->lock);
+		}
+
+		lock_grab(&sp->lock);
+		const Move move = next_move(sp->ss);
+		lock_release(&sp->lock);
+		return move;
+	}
+
+	/// Searches the remaining moves of a split point until none are left or the
+	/// split point fails high. Used by the master and by every thread joining it.
+	void search_split_point(SearchThread& thread, SplitPoint* sp)
+	{
+		Position& pos = thread.pos;
+		SearchStack* ss = thread.stack + sp->ply;
+		UndoInfo u;
+
+		while (true)
+		{
+			const Move move = next_split_move(sp);
+			lock_grab(&sp->lock);
+			if (move == MOVE_NONE)
+			{
+				sp->exhausted = true;
+				lock_release(&sp->lock);
+				break;
+			}
+			const Value alpha = sp->alpha;
+			const Value beta = sp->beta;
+			lock_release(&sp->lock);
 
-		eval = no_move->order_next[0]->eval;
-		return move_to_string(no_move->order_next[0]->move);
+			// younger brothers are scouted with a null window first
+			ss->current_move = move;
+			pos.do_move(move, u);
+			Value eval = -negamax(thread, ss + 1, sp->ply + 1, -alpha - 1, -alpha, sp->depth - 1);
+			if (eval > alpha && eval < beta)
+			{
+				eval = -negamax(thread, ss + 1, sp->ply + 1, -beta, -alpha, sp->depth - 1);
+			}
+			pos.undo_move(move, u);
+
+			// the result of an aborted search is meaningless
+			if (thread_should_stop(thread))
+			{
+				break;
+			}
+
+			lock_grab(&sp->lock);
+			if (eval > sp->best_eval)
+			{
+				sp->best_eval = eval;
+				sp->best_move = move;
+				sp->pv[0] = move;
+				std::copy((ss + 1)->pv, (ss + 1)->pv + (ss + 1)->pv_length, sp->pv + 1);
+				sp->pv_length = (ss + 1)->pv_length + 1;
+				sp->alpha = (std::max)(sp->alpha, eval);
+			}
+
+			if (sp->alpha >= sp->beta) // cutoff reached - stop all threads at the split point
+			{
+				sp->cutoff = true;
+				if (is_quiet(pos, move))
+				{
+					update_quiet_stats(thread, ss, sp->ply, sp->depth, move, nullptr, 0);
+				}
+			}
+			lock_release(&sp->lock);
+		}
+	}
+
+	bool descends_from(const SplitPoint* sp, const SplitPoint* ancestor)
+	{
+		for (; sp; sp = sp->parent)
+		{
+			if (sp == ancestor)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/// Work stealing : looks for the deepest active split point with moves left and
+	/// helps searching it. A master waiting for its slaves only joins split points
+	/// below its own, since its position and stack above them must be kept.
+	/// @return true if a split point was joined
+	bool join_split_point(SearchThread& thread, const SplitPoint* ancestor)
+	{
+		SplitPoint* best = nullptr;
+
+		lock_grab(&split_lock);
+		for (const auto& other : search_threads)
+		{
+			for (int i = 0; i < other->split_count; i++)
+			{
+				SplitPoint* sp = &other->split_points[i];
+				if (!sp->active || sp->cutoff || (best && sp->depth <= best->depth)
+					|| (ancestor && (sp == ancestor || !descends_from(sp, ancestor))))
+				{
+					continue;
+				}
+
+				lock_grab(&sp->lock);
+				const bool moves_left = !sp->exhausted;
+				lock_release(&sp->lock);
+
+				if (moves_left)
+				{
+					best = sp;
+				}
+			}
+		}
+		if (best)
+		{
+			best->slaves++;
+		}
+		lock_release(&split_lock);
+
+		if (!best)
+		{
+			return false;
+		}
+
+		// a helper thread is busy until it leaves the split point
+		const bool idle = ancestor == nullptr;
+		if (idle)
+		{
+			idle_threads--;
+		}
+
+		// the moves searched below the split point are ordered, and counter moves are
+		// recorded, with the master's stack rather than with what is left on this one
+		SearchStack* ss = thread.stack + best->ply;
+		if (best->ply > 0)
+		{
+			(ss - 1)->current_move = best->previous_move;
+		}
+		ss->killers[0] = best->killers[0];
+		ss->killers[1] = best->killers[1];
+		ss->mate_killer = best->mate_killer;
+
+		SplitPoint* previous = thread.current_split;
+		thread.pos = best->pos;
+		thread.current_split = best;
+		search_split_point(thread, best);
+		thread.current_split = previous;
+
+		lock_grab(&split_lock);
+		best->slaves--;
+		lock_release(&split_lock);
+
+		if (idle)
+		{
+			idle_threads++;
+		}
+		return true;
+	}
+
+	/// Shares the remaining moves of a node with the idle threads. The master works
+	/// at the split point too, and helps its slaves once it runs out of moves.
+	void split(SearchThread& thread, SearchStack* ss, int ply, int depth,
+		Value& alpha, Value beta, Value& best_eval, Move& best_move)
+	{
+		SplitPoint* sp = &thread.split_points[thread.split_count];
+		sp->parent = thread.current_split;
+		sp->master = &thread;
+		sp->pos = thread.pos;
+		sp->ss = ss;
+		// the master changes its own position and history table while searching,
+		// so the remaining moves are generated and ordered with the copies held by
+		// the split point
+		if (ss->picker)
+		{
+			sp->history = thread.history;
+			ss->picker->attach(sp->pos, &sp->history);
+		}
+		sp->ply = ply;
+		sp->depth = depth;
+		sp->previous_move = ply > 0 ? (ss - 1)->current_move : MOVE_NONE;
+		sp->killers[0] = ss->killers[0];
+		sp->killers[1] = ss->killers[1];
+		sp->mate_killer = ss->mate_killer;
+		sp->cutoff = false;
+		sp->exhausted = false;
+		sp->alpha = alpha;
+		sp->beta = beta;
+		sp->best_eval = best_eval;
+		sp->best_move = best_move;
+		std::copy(ss->pv, ss->pv + ss->pv_length, sp->pv);
+		sp->pv_length = ss->pv_length;
+
+		lock_grab(&split_lock);
+		sp->slaves = 0;
+		sp->active = true;
+		thread.split_count++;
+		lock_release(&split_lock);
+
+		thread.current_split = sp;
+		search_split_point(thread, sp);
+
+		// wait for the slaves to finish, helping them meanwhile
+		bool helped = false;
+		while (true)
+		{
+			lock_grab(&split_lock);
+			if (sp->slaves == 0)
+			{
+				sp->active = false;
+				thread.split_count--;
+				lock_release(&split_lock);
+				break;
+			}
+			lock_release(&split_lock);
+
+			if (join_split_point(thread, sp))
+			{
+				helped = true;
+			}
+			else
+			{
+				check_time(thread);
+				std::this_thread::yield();
+			}
+		}
+
+		thread.current_split = sp->parent;
+		if (helped)
+		{
+			thread.pos = sp->pos;
+		}
+
+		alpha = sp->alpha;
+		best_eval = sp->best_eval;
+		best_move = sp->best_move;
+		std::copy(sp->pv, sp->pv + sp->pv_length, ss->pv);
+		ss->pv_length = sp->pv_length;
+	}
+
+	/// Helper threads in YBWC mode wait for split points to join until the search ends
+	void idle_loop(SearchThread& thread)
+	{
+		idle_threads++;
+		while (!stop_search)
+		{
+			if (!join_split_point(thread, nullptr))
+			{
+				std::this_thread::yield();
+			}
+		}
+		idle_threads--;
+	}
+
+	/// Principal variation search. The first move of a node is searched with the full
+	/// window, every later move with a null window around alpha, which only proves that
+	/// it is not better. A move failing high on the null window is searched again with
+	/// the full window. Evaluations are from the side to move's point of view.
+	Value negamax(SearchThread& thread, SearchStack* ss, int ply, Value alpha, Value beta, int depth, bool allow_null)
+	{
+		// the horizon is reached, resolve the captures before evaluating
+		if (depth <= 0)
+		{
+			return quiescence(thread, ss, ply, alpha, beta);
+		}
+
+		Position& pos = thread.pos;
+		ss->pv_length = 0;
+		count_node(thread, ply);
+
+		// a draw by rule ends the game, the root is searched anyway to find a move
+		if (ply > 0 && pos.is_draw())
+		{
+			return VALUE_DRAW;
+		}
+
+		// nodes searched with an open window may become part of the principal variation
+		const bool pv_node = beta - alpha > 1;
+
+		// get the zobrist hash key
+		auto key = pos.get_key();
+		Transposition::Entry table_entry;
+		bool table_hit = transposition_table.probe(key, table_entry);
+
+		// the window the node is searched with decides the bound of its evaluation
+		const Value alpha_start = alpha;
+
+		// position should have been seen before and evaluated at an equal or higher depth
+		// if this is the case and the stored bound allows a cutoff, the position need not
+		// be evaluated again
+		// the root is always searched, as the table may hold it from an earlier move, and
+		// so are the other principal variation nodes, so that the variation stays complete
+		const Value table_value = table_hit ? value_from_tt(table_entry.score, ply) : VALUE_NONE;
+		if (ply > 0 && !pv_node && table_hit && table_entry.depth >= depth
+			&& (table_entry.bound == VALUE_TYPE_EXACT
+				|| (table_entry.bound == VALUE_TYPE_LOWER && table_value >= beta)
+				|| (table_entry.bound == VALUE_TYPE_UPPER && table_value <= alpha)))
+		{
+			thread.transpositions++;
+			return table_value;
+		}
+
+		if (ply >= MaxPly - 1)
+		{
+			return evaluate(thread);
+		}
+
+		const bool in_check = pos.is_check();
+
+		// the static evaluation decides the pruning of nodes off the principal variation
+		const Value static_eval = !pv_node && !in_check ? evaluate(thread) : VALUE_NONE;
+
+		// futility pruning of the node : close to the horizon, an evaluation far above
+		// beta is not expected to drop below it again
+		if (enabled(Pruning::Futility) && static_eval != VALUE_NONE && depth <= FutilityDepth
+			&& !is_mate_score(beta) && static_eval - FutilityMargin * depth >= beta)
+		{
+			return static_eval;
+		}
+
+		// razoring : close to the horizon, an evaluation far below alpha is only
+		// searched further if the captures can make up for the difference
+		if (enabled(Pruning::Razoring) && static_eval != VALUE_NONE && depth <= RazorDepth
+			&& !is_mate_score(alpha) && static_eval + RazorMargin * depth <= alpha)
+		{
+			const Value razor_alpha = Value(alpha - RazorMargin * depth);
+			const Value razor_eval = quiescence(thread, ss, ply, razor_alpha, Value(razor_alpha + 1));
+			if (thread_should_stop(thread))
+			{
+				return VALUE_DRAW;
+			}
+			if (razor_eval <= razor_alpha)
+			{
+				return razor_eval;
+			}
+		}
+
+		// null move pruning : if the side to move still fails high after passing, a real
+		// move will almost always fail high too. Passing is not allowed in check, twice in a
+		// row, or with pawns alone, where zugzwang is common.
+		if (allow_null && static_eval != VALUE_NONE && ply > 0 && depth >= NullMoveDepth
+			&& (ss - 1)->current_move != MOVE_NULL
+			&& pos.non_pawn_material(pos.side_to_move()) > VALUE_DRAW)
+		{
+			if (static_eval >= beta)
+			{
+				// the deeper the node and the further the evaluation is above beta,
+				// the more the null move search is reduced
+				const int reduction = 2 + depth / 4 + (std::min)((int(static_eval) - int(beta)) / Evaluation::BISHOP_VAL, 2);
+
+				UndoInfo u_null;
+				ss->current_move = MOVE_NULL;
+				pos.do_null_move(u_null);
+				Value null_eval = -negamax(thread, ss + 1, ply + 1, -beta, -beta + 1, depth - 1 - reduction);
+				pos.undo_null_move(u_null);
+
+				if (thread_should_stop(thread))
+				{
+					return VALUE_DRAW;
+				}
+
+				if (null_eval >= beta)
+				{
+					// a mate found after passing is not proven
+					if (null_eval >= value_mate_in(MaxPly))
+					{
+						null_eval = beta;
+					}
+
+					// close to the root, zugzwang is ruled out by a reduced search of the node
+					// itself, in which no null move is tried
+					if (depth < NullVerificationDepth
+						|| negamax(thread, ss, ply, beta - 1, beta, depth - reduction, false) >= beta)
+					{
+						return null_eval;
+					}
+				}
+			}
+		}
+
+		// the best move found earlier is searched first, move ordering between
+		// iterations comes from the transposition table. The table holds the best
+		// root move only, so later multi PV lines start with their previous move.
+		const Move hash_move = ply == 0 && thread.pv_index > 0 ? thread.root_lines[thread.pv_index].pv[0]
+			: table_hit ? table_entry.move : MOVE_NONE;
+
+		// every node but the root generates its moves in stages : the hash move,
+		// captures, killers and quiet moves, so that a cutoff by one of the first
+		// moves saves generating the others
+		MovePicker picker(pos, pv_node, hash_move, ss->mate_killer, ss->killers[0], ss->killers[1], Depth(depth * OnePly),
+			&thread.history, counter_move(thread, ss, ply));
+		ss->picker = ply > 0 ? &picker : nullptr;
+
+		// the root keeps a list of all its moves
+		if (ply == 0)
+		{
+			populate_next_moves(pos, ss);
+			filter_root_moves(thread, ss);
+			score_moves(pos, ss, hash_move);
+			ss->next_index = 0;
+
+			// helper threads shuffle the quiet moves at the root, so that they
+			// do not all search the same part of the tree
+			if (thread.id > 0)
+			{
+				for (int i = 0; i < ss->move_count; i++)
+				{
+					if (ss->scores[i] < KillerScore)
+					{
+						ss->scores[i] += int(((uint32_t(ss->moves[i]) + uint32_t(thread.id)) * 2654435761u) >> 24);
+					}
+				}
+			}
+		}
+
+		// recurse
+		Value best_eval = -VALUE_INFINITE;
+		Move best_move = MOVE_NONE;
+		int move_count = 0;
+		Move quiets_searched[MaxQuietsSearched];
+		int quiet_count = 0;
+		const Bitboard dc = pos.discovered_check_candidates(pos.side_to_move());
+		UndoInfo u;
+		Move move;
+
+		while ((move = next_move(ss)) != MOVE_NONE)
+		{
+			move_count++;
+			const bool quiet = is_quiet(pos, move);
+
+			// late quiet moves which neither give nor evade check are candidates
+			// for pruning and reductions
+			const bool late_quiet = quiet && move_count > 1 && !in_check && !pos.move_is_check(move, dc);
+
+			if (late_quiet && !pv_node && best_eval > value_mated_in(MaxPly))
+			{
+				// late move pruning : with good move ordering, moves this late rarely
+				// raise alpha close to the horizon
+				if (enabled(Pruning::LateMovePruning) && depth <= LateMovePruningDepth && move_count > late_move_count(depth))
+				{
+					continue;
+				}
+
+				// futility pruning of the move : a quiet move is not expected to make
+				// up for an evaluation far below alpha
+				if (enabled(Pruning::Futility) && depth <= FutilityDepth && static_eval + FutilityMargin * depth <= alpha)
+				{
+					continue;
+				}
+			}
+
+			// late move reductions : the move is searched at a reduced depth first, and
+			// at the full depth only if it turns out better than expected
+			int reduction = 0;
+			if (enabled(Pruning::LateMoveReductions) && late_quiet && depth >= ReductionDepth
+				&& move_count > (pv_node ? 3 : 2) && move != ss->killers[0] && move != ss->killers[1])
+			{
+				reduction = reductions[(std::min)(depth, 63)][(std::min)(move_count, 63)] - (pv_node ? 1 : 0);
+				reduction = (std::max)(0, (std::min)(reduction, depth - 2));
+			}
+
+			ss->current_move = move;
+			pos.do_move(move, u);
+
+			Value eval;
+			if (move_count == 1)
+			{
+				eval = -negamax(thread, ss + 1, ply + 1, -beta, -alpha, depth - 1);
+			}
+			else
+			{
+				// scout, and search again with the full window only if the move may raise alpha
+				eval = -negamax(thread, ss + 1, ply + 1, -alpha - 1, -alpha, depth - 1 - reduction);
+				if (reduction > 0 && eval > alpha)
+				{
+					eval = -negamax(thread, ss + 1, ply + 1, -alpha - 1, -alpha, depth - 1);
+				}
+				if (eval > alpha && eval < beta)
+				{
+					eval = -negamax(thread, ss + 1, ply + 1, -beta, -alpha, depth - 1);
+				}
+			}
+			pos.undo_move(move, u);
+
+			// the result of an aborted search is meaningless
+			if (thread_should_stop(thread))
+			{
+				return VALUE_DRAW;
+			}
+
+			if (eval > best_eval)
+			{
+				best_eval = eval;
+				best_move = move;
+
+				// the principal variation is the move followed by the one of the child
+				ss->pv[0] = move;
+				std::copy((ss + 1)->pv, (ss + 1)->pv + (ss + 1)->pv_length, ss->pv + 1);
+				ss->pv_length = (ss + 1)->pv_length + 1;
+
+				// a new best move at the root of a long search is reported at once
+				if (ply == 0 && thread.id == 0 && move_count > 1 && eval > alpha && eval < beta && search_time() > ReportDelay)
+				{
+					report(thread, depth, thread.pv_index, eval, VALUE_TYPE_EXACT, ss->pv, ss->pv_length);
+				}
+
+				alpha = (std::max)(alpha, eval);
+			}
+
+			// a move mating from here is tried early in sibling positions
+			if (eval >= value_mate_in(MaxPly))
+			{
+				ss->mate_killer = move;
+			}
+
+			if (alpha >= beta) // cutoff reached - stop looking at other moves
+			{
+				if (quiet)
+				{
+					update_quiet_stats(thread, ss, ply, depth, move, quiets_searched, quiet_count);
+				}
+				break;
+			}
+
+			if (quiet && quiet_count < MaxQuietsSearched)
+			{
+				quiets_searched[quiet_count++] = move;
+			}
+
+			// young brothers wait : once the eldest brother has been searched, the
+			// remaining moves can be shared with idle threads
+			if (depth >= MinSplitDepth && idle_threads > 0 && thread.split_count < MaxSplitPoints)
+			{
+				split(thread, ss, ply, depth, alpha, beta, best_eval, best_move);
+				if (thread_should_stop(thread))
+				{
+					return VALUE_DRAW;
+				}
+				break;
+			}
+		}
+
+		// no legal moves, checkmated or stalemated, mates are counted in plies from the
+		// root so that shorter mates are preferred
+		if (move_count == 0)
+		{
+			const Value eval = in_check ? value_mated_in(ply) : VALUE_DRAW;
+
+			// terminal position evaluated
+			transposition_table.store(key, depth, VALUE_TYPE_EXACT, value_to_tt(eval, ply), MOVE_NONE);
+			return eval;
+		}
+
+		// the best of the remaining root moves of a later multi PV line, or of a
+		// restricted set of root moves, must not replace the best root move in the table
+		if (ply == 0 && (thread.pv_index > 0 || !search_moves.empty()))
+		{
+			return best_eval;
+		}
+
+		// non-terminal position evaluated
+		// a score outside the search window only bounds the true evaluation
+		ValueType bound = VALUE_TYPE_EXACT;
+		if (best_eval <= alpha_start)
+		{
+			bound = VALUE_TYPE_UPPER;
+		}
+		else if (best_eval >= beta)
+		{
+			bound = VALUE_TYPE_LOWER;
+		}
+		transposition_table.store(key, depth, bound, value_to_tt(best_eval, ply), best_move);
+
+		return best_eval;
+	}
+
+	/// Runs iterative deepening on the thread's position until the search is stopped.
+	/// The main thread stops all threads once it has run out of time or has
+	/// completed the maximum depth. In multi PV mode, every iteration of the main
+	/// thread searches the root once per line, each time without the root moves of
+	/// the lines found before, while the table and the move ordering are shared.
+	void iterative_deepening(SearchThread& thread, int max_depth)
+	{
+		const bool main_thread = thread.id == 0;
+
+		Move root_moves[MaxMoves];
+		const int root_move_count = int(std::count_if(root_moves, root_moves + thread.pos.all_legal_moves(root_moves), is_search_move));
+		thread.pv_count = main_thread ? (std::max)(1, (std::min)(multi_pv, root_move_count)) : 1;
+
+		for (int depth = 1; depth <= max_depth; depth++)
+		{
+			// helper threads search every other iteration one ply deeper, so that
+			// they spread over more of the tree than the main thread, but never
+			// deeper than the depth asked for
+			const int search_depth = main_thread ? depth : (std::min)(depth + (thread.id & 1), max_depth);
+
+			for (thread.pv_index = 0; thread.pv_index < thread.pv_count; thread.pv_index++)
+			{
+				RootLine& line = thread.root_lines[thread.pv_index];
+
+				// aspiration window : the evaluation is expected close to the one of the previous
+				// iteration, a narrow window around it prunes more of the tree
+				Value alpha = -VALUE_INFINITE;
+				Value beta = VALUE_INFINITE;
+				int delta = AspirationWindow;
+				if (depth >= AspirationDepth && line.pv_length > 0 && !is_mate_score(line.eval))
+				{
+					alpha = Value((std::max)(int(line.eval) - delta, -int(VALUE_INFINITE)));
+					beta = Value((std::min)(int(line.eval) + delta, int(VALUE_INFINITE)));
+				}
+
+				Value eval;
+				while (true)
+				{
+					eval = negamax(thread, thread.stack, 0, alpha, beta, search_depth);
+					if (stop_search)
+					{
+						break;
+					}
+
+					if (main_thread && (eval <= alpha || eval >= beta) && search_time() > ReportDelay)
+					{
+						report(thread, search_depth, thread.pv_index, eval, eval <= alpha ? VALUE_TYPE_UPPER : VALUE_TYPE_LOWER,
+							thread.stack[0].pv, thread.stack[0].pv_length);
+					}
+
+					// the evaluation fell outside the window, widen it on the failing side
+					if (eval <= alpha)
+					{
+						alpha = Value((std::max)(int(eval) - delta, -int(VALUE_INFINITE)));
+					}
+					else if (eval >= beta)
+					{
+						beta = Value((std::min)(int(eval) + delta, int(VALUE_INFINITE)));
+					}
+					else
+					{
+						break;
+					}
+					delta *= 2;
+				}
+
+				if (stop_search || thread.stack[0].pv_length == 0)
+				{
+					break;
+				}
+
+				line.eval = eval;
+				std::copy(thread.stack[0].pv, thread.stack[0].pv + thread.stack[0].pv_length, line.pv);
+				line.pv_length = thread.stack[0].pv_length;
+			}
+
+			if (stop_search || thread.pv_index < thread.pv_count)
+			{
+				break;
+			}
+
+			// a later line may have turned out better than an earlier one at this depth
+			std::stable_sort(thread.root_lines, thread.root_lines + thread.pv_count,
+				[](const RootLine& a, const RootLine& b) { return a.eval > b.eval; });
+
+			const RootLine& best = thread.root_lines[0];
+			const bool best_move_changed = thread.best_move != best.pv[0];
+			thread.completed_depth = search_depth;
+			thread.best_move = best.pv[0];
+			thread.ponder_move = best.pv_length > 1 ? best.pv[1] : MOVE_NONE;
+			thread.best_eval = best.eval;
+
+			if (!main_thread)
+			{
+				continue;
+			}
+
+			time_manager.iteration_completed(best_move_changed);
+
+			for (int i = 0; i < thread.pv_count; i++)
+			{
+				const RootLine& line = thread.root_lines[i];
+				report(thread, search_depth, i, line.eval, VALUE_TYPE_EXACT, line.pv, line.pv_length);
+			}
+
+			if (depth == max_depth)
+			{
+				break;
+			}
+
+			// If mate found, no need to evaluate deeper, unless the other lines are wanted too
+			// or a shorter mate is searched for
+			if (thread.pv_count == 1 && is_mate_score(best.eval) && mate_limit == 0)
+			{
+				break;
+			}
+
+			// a mate within the moves asked for ends the search
+			if (mate_limit > 0 && best.eval >= value_mate_in(2 * mate_limit - 1))
+			{
+				break;
+			}
+
+			// if there's only one move, no point recursing to higher depths
+			if (root_move_count == 1)
+			{
+				break;
+			}
+
+			//std::cout << "---- Search at Depth " << depth << " completed. ----\n";
+			//std::cout << thread.transpositions << " Transpositions\n";
+
+			// an iteration which would not be completed in time is not started
+			if (!pondering && time_manager.soft_limit_reached())
+			{
+				break;
+			}
+		}
+
+		thread.pv_index = 0;
+		if (main_thread)
+		{
+			stop_search = true;
+		}
+	}
+
+	/// Searches the position with all threads
+	/// @param[in] pos The position
+	/// @param[in] limits The clocks or the fixed time of the search
+	/// @param[in] max_depth The depth of the last iteration
+	/// @param[out] eval The evaluation of the best move from the side to move's point of view
+	/// @param[out] ponder_move The expected reply to the best move, MOVE_NONE if unknown
+	/// @return the best move
+	Move think(const Position& pos, const SearchLimits& limits, int max_depth, Value& eval, Move& ponder_move)
+	{
+		ponder_move = MOVE_NONE;
+		const Color us = pos.side_to_move();
+		if (limits.infinite)
+		{
+			time_manager.start(0, 0, 0, 0, move_overhead);
+		}
+		else
+		{
+			time_manager.start(limits.time[us], limits.increment[us], limits.moves_to_go, limits.move_time, move_overhead);
+		}
+		transposition_table.new_search();
+		search_start = std::chrono::steady_clock::now();
+		node_limit = limits.nodes;
+		mate_limit = limits.mate;
+		search_moves = limits.search_moves;
+
+		// a stop may have arrived before the search has started
+		stop_search = stop_requested.load();
+
+		for (auto& thread : search_threads)
+		{
+			thread->pos = pos;
+			thread->nodes = 0;
+			thread->sel_depth = 0;
+			thread->transpositions = 0;
+			thread->completed_depth = 0;
+			thread->best_move = MOVE_NONE;
+			thread->ponder_move = MOVE_NONE;
+			thread->best_eval = VALUE_DRAW;
+			for (auto& line : thread->root_lines)
+			{
+				line.pv_length = 0;
+			}
+			thread->current_split = nullptr;
+			for (auto& frame : thread->stack)
+			{
+				frame.killers[0] = frame.killers[1] = MOVE_NONE;
+				frame.mate_killer = MOVE_NONE;
+			}
+			thread->history.clear();
+		}
+
+		// lazy SMP : the helper threads run the same iterative deepening on their own
+		// copy of the position and only share their results through the transposition table
+		// YBWC : the helper threads join the split points of the main thread's search
+		std::vector<std::thread> helpers;
+		for (std::size_t i = 1; i < search_threads.size(); i++)
+		{
+			if (smp_mode == SmpMode::YBWC)
+			{
+				helpers.emplace_back(idle_loop, std::ref(*search_threads[i]));
+			}
+			else
+			{
+				helpers.emplace_back(iterative_deepening, std::ref(*search_threads[i]), max_depth);
+			}
+		}
+
+		iterative_deepening(*search_threads[0], max_depth);
+
+		// an infinite search only ends when the GUI stops it, and a pondering search
+		// must not report its move before the opponent has played
+		while ((limits.infinite || pondering) && !stop_requested)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		for (auto& helper : helpers)
+		{
+			helper.join();
+		}
+
+		// take the result of the deepest completed search, preferring the main thread
+		const SearchThread* best_thread = search_threads[0].get();
+		for (const auto& thread : search_threads)
+		{
+			if (thread->completed_depth > best_thread->completed_depth && thread->best_move != MOVE_NONE)
+			{
+				best_thread = thread.get();
+			}
+		}
+
+		// stopped before the first iteration was completed, any legal move is better than none
+		if (best_thread->best_move == MOVE_NONE)
+		{
+			Move moves[MaxMoves];
+			const int count = pos.all_legal_moves(moves);
+			eval = VALUE_DRAW;
+			const Move* move = std::find_if(moves, moves + count, is_search_move);
+			return move != moves + count ? *move : count > 0 ? moves[0] : MOVE_NONE;
+		}
+
+		eval = best_thread->best_eval;
+		ponder_move = best_thread->ponder_move;
+		return best_thread->best_move;
+	}
+
+	void bench(int depth)
+	{
+		static const char* bench_positions[] =
+		{
+			"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+			"r1b2r1k/ppp3pp/3b1qn1/5p2/3N4/1Q3B2/PPP2PPP/R1BR2K1 w - - 6 15",
+			"r4b1r/ppp2pp1/3k1q2/7p/2P5/P2N3Q/2PN1PPP/4R1K1 b - - 3 21",
+			"3r2k1/Qp4p1/7p/3p4/8/5PP1/4r2P/5qNK b - - 0 32",
+			"2kR1b1r/ppp2ppp/7n/4p3/2B1N3/4Bn2/PPP2P1P/2K3R1 b - - 0 16",
+			"8/k7/3p4/p2P1p2/P2P1P2/8/8/K7 w - - 0 1"
+		};
+
+		// a stop of the last game search is still set, and would end every search at once
+		stop_requested = false;
+		pondering = false;
+
+		uint64_t total_nodes = 0;
+		double total_time = 0.;
+
+		// the evaluation tables count their probes for their whole life
+		uint64_t pawn_probes = 0, pawn_hits = 0;
+		uint64_t material_probes = 0, material_hits = 0;
+		uint64_t eval_probes = 0, eval_hits = 0;
+		for (const auto& thread : search_threads)
+		{
+			eval_probes -= thread->eval_cache.probes();
+			eval_hits -= thread->eval_cache.hits();
+			pawn_probes -= thread->pawn_table.probes();
+			pawn_hits -= thread->pawn_table.hits();
+			material_probes -= thread->material_table.probes();
+			material_hits -= thread->material_table.hits();
+		}
+
+		for (const char* fen : bench_positions)
+		{
+			// every position is searched from an empty table, so that a single
+			// threaded run always visits the same number of nodes
+			new_game();
+			Value eval;
+			const auto start = std::chrono::steady_clock::now();
+			Move ponder_move;
+			Move move = think(Position(fen), SearchLimits(), depth, eval, ponder_move);
+			const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			const uint64_t nodes = nodes_searched();
+
+			std::cout << "info string " << fen << " bestmove " << move_to_string(move)
+				<< " nodes " << nodes << " time " << int(elapsed * 1000) << std::endl;
+			total_nodes += nodes;
+			total_time += elapsed;
+		}
+
+		std::cout << "info string threads " << search_threads.size()
+			<< " mode " << (smp_mode == SmpMode::YBWC ? "YBWC" : "LazySMP")
+			<< " depth " << depth
+			<< " nodes " << total_nodes
+			<< " time " << int(total_time * 1000)
+			<< " nps " << uint64_t(total_nodes / (std::max)(total_time, 0.001)) << std::endl;
+
+		for (const auto& thread : search_threads)
+		{
+			pawn_probes += thread->pawn_table.probes();
+			pawn_hits += thread->pawn_table.hits();
+			material_probes += thread->material_table.probes();
+			material_hits += thread->material_table.hits();
+			eval_probes += thread->eval_cache.probes();
+			eval_hits += thread->eval_cache.hits();
+		}
+		std::cout << "info string eval cache probes " << eval_probes
+			<< " hit rate " << (eval_probes ? 100. * eval_hits / eval_probes : 0.) << "%" << std::endl;
+		std::cout << "info string pawn table probes " << pawn_probes
+			<< " hit rate " << (pawn_probes ? 100. * pawn_hits / pawn_probes : 0.) << "%"
+			<< " material table probes " << material_probes
+			<< " hit rate " << (material_probes ? 100. * material_hits / material_probes : 0.) << "%" << std::endl;
+	}
+
+	/// The reply to a move stored in the transposition table, for pondering when the
+	/// principal variation has been cut short
+	Move expected_reply(const Position& pos, Move move)
+	{
+		Position next = pos;
+		UndoInfo u;
+		next.do_move(move, u);
+
+		Transposition::Entry entry;
+		if (!transposition_table.probe(next.get_key(), entry) || entry.move == MOVE_NONE)
+		{
+			return MOVE_NONE;
+		}
+
+		Move moves[MaxMoves];
+		const int count = next.all_legal_moves(moves);
+		return std::find(moves, moves + count, entry.move) != moves + count ? entry.move : MOVE_NONE;
+	}
+
+	std::string play_move(Position& pos, Value& eval, std::string& ponder, const Evaluation::Book& book, const SearchLimits& limits)
+	{
+		ponder = "";
+
+		// Try to find a random move from the book
+		std::mt19937 rand_gen(time(NULL));
+		const Key pos_key = pos.get_key();
+		std::vector<Move> book_moves;
+		if (book.find(pos_key) != book.end())
+		{
+			const auto& move_set = book.find(pos_key)->second;
+			book_moves = std::vector<Move>(move_set.begin(), move_set.end());
+		}
+
+		// see if there are more than one choices, an analysis or a search with limits
+		// other than the clock never plays from the book
+		const bool analysis = limits.infinite || limits.ponder || limits.depth > 0 || limits.nodes > 0
+			|| limits.mate > 0 || !limits.search_moves.empty();
+		if (book_moves.size() > 1 && !analysis)
+		{
+			std::uniform_int_distribution<std::size_t> rand_idx(0, book_moves.size() - 1);
+			auto idx = rand_idx(rand_gen);
+			//std::cout << "Choosing random move from " << book_moves.size() << " moves. Move Index [" << idx << "]\n";
+			auto choosen_move = book_moves[idx];
+			return move_to_string(choosen_move);
+		}
+
+		//std::cout << "Did not find book move..\n";
+
+		// Iterative Deepening searches the move tree by iteratively increasing 
+		// the depth to a max depth. This may sound counterintuitive, since
+		// we end up evaluating many of the same positions again, but the move ordering 
+		// obtained during previous searches at lower depths can help in pruning 
+		// more branches at higher depths.
+
+		Move ponder_move;
+		Move best_move = think(pos, limits, limits.depth > 0 ? (std::min)(limits.depth, MaxPly - 1) : MaxPly - 1, eval, ponder_move);
+
+		// the search evaluates from the side to move's point of view
+		if (pos.side_to_move() == Color::BLACK)
+		{
+			eval = -eval;
+		}
+
+		if (best_move == MOVE_NONE)
+		{
+			return "";
+		}
+
+		if (ponder_move == MOVE_NONE)
+		{
+			ponder_move = expected_reply(pos, best_move);
+		}
+		if (ponder_move != MOVE_NONE)
+		{
+			ponder = move_to_string(ponder_move);
+		}
+
+		return move_to_string(best_move);
+	}
+
+	void start_search(const Position& pos, const Evaluation::Book& book, const SearchLimits& limits,
+		std::function<void(const std::string&, const std::string&, Value)> on_done)
+	{
+		wait_for_search();
+		stop_requested = false;
+		pondering = limits.ponder;
+		search_worker = std::thread([pos, &book, limits, on_done]()
+		{
+			Position root = pos;
+			Value eval = VALUE_DRAW;
+			std::string ponder;
+			const std::string best_move = play_move(root, eval, ponder, book, limits);
+			on_done(best_move, ponder, eval);
+		});
+	}
+
+	void ponderhit()
+	{
+		time_manager.ponderhit();
+		pondering = false;
+	}
+
+	void stop()
+	{
+		stop_requested = true;
+		stop_search = true;
+	}
+
+	void wait_for_search()
+	{
+		if (search_worker.joinable())
+		{
+			search_worker.join();
+		}
+	}
+
+	void send(const std::string& line)
+	{
+		std::lock_guard<std::mutex> guard(output_mutex);
+		std::cout << line << std::endl;
 	}
-}
\ No newline at end of file
+}
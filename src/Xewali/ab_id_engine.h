@@ -4,6 +4,8 @@
 */
 
 #pragma once
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 #include <random>
@@ -12,17 +14,114 @@
 
 namespace AbIterDeepEngine
 {
+	/// Maximum number of search threads
+	constexpr int MaxThreads = 256;
+
+	/// Maximum number of principal variations searched in multi PV mode
+	constexpr int MaxMultiPV = 64;
+
+	/// How the search is shared between threads
+	enum class SmpMode
+	{
+		LazySMP,	///< every thread runs its own iterative deepening on a shared table
+		YBWC		///< helper threads join split points of the main search
+	};
+
+	/// Selective search techniques which can be switched off, e.g. to compare their effect
+	enum class Pruning
+	{
+		LateMoveReductions,	///< late quiet moves are searched at a reduced depth first
+		Futility,			///< quiet moves and nodes far from the window are pruned close to the horizon
+		Razoring,			///< nodes far below alpha drop into the quiescence search close to the horizon
+		LateMovePruning		///< late quiet moves are not searched at all close to the horizon
+	};
+
+	/// The limits a search is started with
+	struct SearchLimits
+	{
+		int time[2] = { 0, 0 };			///< time left on the clocks in ms, indexed by color
+		int increment[2] = { 0, 0 };	///< increments per move in ms, indexed by color
+		int moves_to_go = 0;			///< moves to the next time control, 0 if unknown
+		int move_time = 0;				///< fixed time for the move in ms, 0 if none
+		bool infinite = false;			///< search until stopped, the book is not used
+		bool ponder = false;			///< search on the opponent's time until ponderhit or stop
+		int depth = 0;					///< last iteration in plies, 0 if none
+		uint64_t nodes = 0;				///< number of nodes after which the search stops, 0 if none
+		int mate = 0;					///< stop once a mate in this many moves is found, 0 if none
+		std::vector<Chess::Move> search_moves;	///< the root moves to search, all if empty
+	};
+
 	/// initializes bitboards
 	void init();
 
-	/// Finds the best move at the given position using minimax and iterative deepening
+	/// Sets the number of threads searching in parallel
+	/// @param[in] count The number of threads, including the main thread
+	void set_threads(int count);
+
+	/// Selects the parallel search algorithm
+	/// @param[in] mode Lazy SMP or young brothers wait split points
+	void set_smp_mode(SmpMode mode);
+
+	/// Sets the number of best root moves searched and reported, each with its own
+	/// principal variation. Only the first one is played.
+	/// @param[in] count The number of principal variations
+	void set_multi_pv(int count);
+
+	/// Switches a selective search technique on or off, all are on by default
+	/// @param[in] technique The technique
+	/// @param[in] enabled Whether the technique is used
+	void set_pruning(Pruning technique, bool enabled);
+
+	/// Searches a fixed set of positions to a fixed depth and reports nodes and time,
+	/// so that parallel speedups can be compared against a single threaded search
+	/// @param[in] depth The depth of the search
+	void bench(int depth);
+
+	/// Finds the best move at the given position using principal variation search and iterative deepening
 	/// The move tree is pruned using alpha beta pruning
 	/// @param[in] pos The position
-	/// @param[out] eval The evaluation at the current position
+	/// @param[out] eval The evaluation at the current position from white's point of view
+	/// @param[out] ponder The expected reply to the best move, empty if unknown
 	/// @param[in] book The opening book
-	/// @param[in] time_to_move The CPU time taken to evaluate a move
+	/// @param[in] limits The clocks or the fixed time of the search
 	/// @return the best move
-	std::string play_move(Chess::Position& pos, double& eval, const Evaluation::Book& book, double time_to_move = 1.0);
+	std::string play_move(Chess::Position& pos, Chess::Value& eval, std::string& ponder, const Evaluation::Book& book, const SearchLimits& limits);
+
+	/// Starts searching on a separate thread and returns at once, so that the caller
+	/// can keep reading commands. A running search is waited for first.
+	/// @param[in] pos The position
+	/// @param[in] book The opening book, it must outlive the search
+	/// @param[in] limits The clocks or the fixed time of the search
+	/// @param[in] on_done Called from the search thread with the best move, the expected
+	/// reply and the evaluation from white's point of view once the search has ended
+	void start_search(const Chess::Position& pos, const Evaluation::Book& book, const SearchLimits& limits,
+		std::function<void(const std::string&, const std::string&, Chess::Value)> on_done);
+
+	/// The opponent has played the move pondered on : the running search continues
+	/// as a normal timed search, with the clock started now
+	void ponderhit();
+
+	/// Stops a running search as soon as possible, it still reports its best move
+	void stop();
+
+	/// Blocks until a running search has ended
+	void wait_for_search();
+
+	/// Writes a line to the GUI. Lines written by the search and by the command loop
+	/// are never interleaved.
+	/// @param[in] line The line without the line break
+	void send(const std::string& line);
+
+	/// Sets the time kept in reserve per move for the communication with the GUI
+	/// @param[in] ms The time in ms
+	void set_move_overhead(int ms);
+
+	/// Resizes the transposition table
+	/// @param[in] mb The size of the table in MB
+	void set_hash_size(std::size_t mb);
+
+	/// Clears the transposition table, which is otherwise kept between moves
+	void new_game();
 
 	/// Sets a position using a position denoted by a fen string and a sequence of moves following the position
 	/// @param[out] pos The position
@@ -0,0 +1,120 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include "Xewali/endgames.h"
+#include "Xewali/evaluation.h"
+
+namespace Endgames
+{
+	namespace
+	{
+		/// The material of a side in centipawns
+		int material(const Position& pos, Color c)
+		{
+			int value = 0;
+			for (auto p = PieceType::PAWN; p <= PieceType::QUEEN; p++)
+			{
+				value += pos.piece_count(c, p) * Evaluation::PieceValues[p];
+			}
+			return value;
+		}
+
+		/// Grows from 1 in the centre to 7 on the edge of the board
+		int distance_from_centre(Square sq)
+		{
+			return (std::max)(std::abs(2 * int(square_file(sq)) - 7), std::abs(2 * int(square_rank(sq)) - 7));
+		}
+
+		/// @return true if all pawns of a side are on the same rook file, which is stored in f
+		bool pawns_on_rook_file(const Position& pos, Color c, File& f)
+		{
+			const Bitboard pawns = pos.pawns(c);
+			if (!(pawns & ~FileABB))
+			{
+				f = FILE_A;
+				return true;
+			}
+			if (!(pawns & ~FileHBB))
+			{
+				f = FILE_H;
+				return true;
+			}
+			return false;
+		}
+	}
+
+	Value kxk(const Position& pos, Color strong)
+	{
+		const Square winner = pos.king_square(strong);
+		const Square loser = pos.king_square(opposite_color(strong));
+
+		return Value(material(pos, strong)
+			+ 10 * distance_from_centre(loser)
+			+ 10 * (7 - square_distance(winner, loser)));
+	}
+
+	Value kbnk(const Position& pos, Color strong)
+	{
+		const Square winner = pos.king_square(strong);
+		const Square loser = pos.king_square(opposite_color(strong));
+
+		// the mate is only forced in a corner the bishop controls
+		const bool dark_corners = square_color(pos.bishop_list(strong, 0)) == square_color(SQ_A1);
+		const int corner_distance = dark_corners
+			? (std::min)(square_distance(loser, SQ_A1), square_distance(loser, SQ_H8))
+			: (std::min)(square_distance(loser, SQ_A8), square_distance(loser, SQ_H1));
+
+		return Value(material(pos, strong)
+			+ 20 * (7 - corner_distance)
+			+ 10 * (7 - square_distance(winner, loser)));
+	}
+
+	ScaleFactor kbpsk(const Position& pos, Color strong)
+	{
+		File file;
+		if (!pawns_on_rook_file(pos, strong, file))
+		{
+			return SCALE_FACTOR_NONE;
+		}
+
+		const Square queening = relative_square(strong, make_square(file, RANK_8));
+		if (square_color(queening) != square_color(pos.bishop_list(strong, 0))
+			&& square_distance(queening, pos.king_square(opposite_color(strong))) <= 1)
+		{
+			return SCALE_FACTOR_ZERO;
+		}
+		return SCALE_FACTOR_NONE;
+	}
+
+	ScaleFactor kpsk(const Position& pos, Color strong)
+	{
+		File file;
+		if (!pawns_on_rook_file(pos, strong, file))
+		{
+			return SCALE_FACTOR_NONE;
+		}
+
+		const Square queening = relative_square(strong, make_square(file, RANK_8));
+		if (square_distance(queening, pos.king_square(opposite_color(strong))) <= 1)
+		{
+			return SCALE_FACTOR_ZERO;
+		}
+		return SCALE_FACTOR_NONE;
+	}
+
+	ScaleFactor opposite_bishops(const Position& pos, Color strong)
+	{
+		if (square_color(pos.bishop_list(WHITE, 0)) == square_color(pos.bishop_list(BLACK, 0)))
+		{
+			return SCALE_FACTOR_NONE;
+		}
+
+		// a single extra pawn is almost always a draw
+		const int extra_pawns = pos.pawn_count(strong) - pos.pawn_count(opposite_color(strong));
+		return extra_pawns <= 1 ? ScaleFactor(SCALE_FACTOR_NORMAL / 4) : ScaleFactor(SCALE_FACTOR_NORMAL / 2);
+	}
+}
@@ -0,0 +1,46 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#pragma once
+#include "Chess/position.h"
+#include "Chess/scale.h"
+
+using namespace Chess;
+
+namespace Endgames
+{
+	/// Evaluates a known endgame in place of the general evaluation
+	/// @param[in] pos The position
+	/// @param[in] strong The side with the winning material
+	/// @return the evaluation in centipawns from the strong side's point of view
+	using EvaluationFunction = Value (*)(const Position& pos, Color strong);
+
+	/// Scales down the endgame score of a side in endgames which are harder to win
+	/// than the material suggests
+	/// @param[in] pos The position
+	/// @param[in] strong The side whose score is scaled
+	/// @return the scale factor, SCALE_FACTOR_NONE if the position is not drawish
+	using ScalingFunction = ScaleFactor (*)(const Position& pos, Color strong);
+
+	/// Mating material against the bare king : the king is driven to the edge,
+	/// with the strong king close to it
+	Value kxk(const Position& pos, Color strong);
+
+	/// Bishop and knight against the bare king : the king is driven to a corner
+	/// of the bishop's color
+	Value kbnk(const Position& pos, Color strong);
+
+	/// Bishop and pawns on a rook file against the bare king : drawn if the bishop
+	/// does not control the promotion square and the weak king reaches it
+	ScaleFactor kbpsk(const Position& pos, Color strong);
+
+	/// Pawns on a rook file against the bare king : drawn if the weak king stands
+	/// in front of the pawns
+	ScaleFactor kpsk(const Position& pos, Color strong);
+
+	/// Bishops of opposite colors and pawns only : the side ahead in pawns can
+	/// rarely force a passed pawn through
+	ScaleFactor opposite_bishops(const Position& pos, Color strong);
+}
@@ -0,0 +1,40 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#include "Xewali/eval_cache.h"
+
+namespace EvalCache
+{
+	namespace
+	{
+		constexpr uint64_t KeyMask = ~uint64_t(0xFFFF);
+	}
+
+	Table::Table()
+		: entries(new uint64_t[TableSize]())
+	{
+	}
+
+	bool Table::probe(Key key, Value& eval)
+	{
+		const uint64_t data = entries[key & (TableSize - 1)];
+		probe_count++;
+
+		// the key bits of an empty entry are zero, so it practically never matches
+		if ((data & KeyMask) != (key & KeyMask))
+		{
+			return false;
+		}
+
+		hit_count++;
+		eval = Value(int16_t(data & 0xFFFF));
+		return true;
+	}
+
+	void Table::store(Key key, Value eval)
+	{
+		entries[key & (TableSize - 1)] = (key & KeyMask) | uint16_t(int16_t(eval));
+	}
+}
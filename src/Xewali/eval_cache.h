@@ -0,0 +1,52 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include "Chess/types.h"
+#include "Chess/value.h"
+
+using namespace Chess;
+
+namespace EvalCache
+{
+	/// Number of entries in an evaluation cache, a power of two
+	constexpr int TableSize = 65536;
+
+	/// A direct mapped cache of static evaluations indexed by the zobrist key of the
+	/// position. Every search thread has its own cache. An entry packs the upper 48
+	/// bits of the key and the evaluation into one word, a colliding position simply
+	/// replaces the entry.
+	/// Only evaluations which depend on the position alone may be stored, draws by
+	/// repetition or by the 50 moves rule must be detected before the cache is probed.
+	class Table
+	{
+	public:
+		Table();
+
+		/// Looks up the evaluation of a position
+		/// @param[in] key The zobrist key of the position
+		/// @param[out] eval The stored evaluation
+		/// @return true if the position was found, false otherwise
+		bool probe(Key key, Value& eval);
+
+		/// Stores the evaluation of a position
+		/// @param[in] key The zobrist key of the position
+		/// @param[in] eval The evaluation
+		void store(Key key, Value eval);
+
+		/// @return the number of probes since the cache was created
+		uint64_t probes() const { return probe_count; }
+
+		/// @return the number of probes which found their position
+		uint64_t hits() const { return hit_count; }
+
+	private:
+		std::unique_ptr<uint64_t[]> entries;
+		uint64_t probe_count = 0;
+		uint64_t hit_count = 0;
+	};
+}
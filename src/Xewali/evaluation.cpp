@@ -49,20 +49,59 @@ namespace Evaluation
 		}
 	}
 
-	double eval(Position& pos)
+	void init()
 	{
-		int res;
-		if (has_game_ended(pos, res))
+		int mg[8][64] = {};
+		int eg[8][64] = {};
+
+		const int* tables[8] = { nullptr, WhitePawnTable, WhiteKnightTable, WhiteBishopTable, WhiteRookTable, WhiteQueenTable, WhiteKingMGTable, nullptr };
+		for (auto p = PieceType::PAWN; p <= PieceType::KING; p++)
+		{
+			// the king is never captured, its value would only shift every evaluation
+			const int value = p == PieceType::KING ? 0 : PieceValues[p];
+			for (Square sq = SQ_A1; sq <= SQ_H8; sq++)
+			{
+				mg[p][sq] = value + tables[p][sq];
+				eg[p][sq] = value + (p == PieceType::KING ? WhiteKingEGTable[sq] : tables[p][sq]);
+			}
+		}
+
+		// the pieces of white are indexed by their type
+		Position::init_piece_square_tables(mg, eg);
+	}
+
+	Value eval(Position& pos, Pawns::Table& pawn_table, Material::Table& material_table)
+	{
+		// the piece combination decides material draws, the phase and known endgames
+		const Material::Entry* material = material_table.probe(pos);
+		if (material->is_draw())
 		{
-			return res;
+			return VALUE_DRAW;
 		}
 
+		if (material->has_evaluation_function())
+		{
+			return material->evaluate(pos);
+		}
+
+		// material and piece tables are kept up to date by Position. It adds half a
+		// tempo for the side to move, which is not part of this evaluation.
+		const int tempo_sign = pos.side_to_move() == Color::WHITE ? 1 : -1;
+		int mg = pos.mg_value() - tempo_sign * (TempoValueMidgame / 2);
+		int eg = pos.eg_value() - tempo_sign * (TempoValueEndgame / 2);
+
+		// the pawn structure rarely changes, its evaluation comes from the thread's pawn table
+		Pawns::Entry* pawns = pawn_table.probe(pos);
+		mg += pawns->mg_value() + pawns->king_shelter(pos, WHITE) - pawns->king_shelter(pos, BLACK);
+		eg += pawns->eg_value();
+
+		mg += material->imbalance_mg();
+		eg += material->imbalance_eg();
+
 		Bitboard attack_bb[2][7];
-		int material[2];
 
 		for (Color color = WHITE; color <= BLACK; color++)
 		{
-			material[color] = 0;
 			for (auto p = PieceType::PAWN; p <= KING; p++)
 			{
 				attack_bb[color][p] = EmptyBoardBB;
@@ -77,18 +116,25 @@ namespace Evaluation
 				auto sq = pos.pawn_list(color, i);
 				auto attacks = color == Color::WHITE ? pos.white_pawn_attacks(sq) : pos.black_pawn_attacks(sq);
 				attack_bb[color][PieceType::PAWN] |= attacks;
-				material[color] += PAWN_VAL;
-				material[color] += color == Color::WHITE ? WhitePawnTable[sq] : BlackPawnTable[sq];
 			}
 
+			// knights and bishops on squares in the enemy half which their own pawns
+			// defend and no enemy pawn can attack
+			const int sign = color == Color::WHITE ? 1 : -1;
+			const Bitboard outposts = pawns->pawn_attacks(color) & ~pawns->attack_span(opposite_color(color))
+				& (relative_rank_bb(color, RANK_5) | relative_rank_bb(color, RANK_6) | relative_rank_bb(color, RANK_7));
+
 			// Bishops
 			for (int i = 0; i < pos.bishop_count(color); i++)
 			{
 				auto sq = pos.bishop_list(color, i);
 				auto attacks = pos.bishop_attacks(sq) & (~attack_bb[opposite_color(color)][PieceType::PAWN]);
 				attack_bb[color][PieceType::BISHOP] |= attacks;
-				material[color] += BISHOP_VAL;
-				material[color] += color == Color::WHITE ? WhiteBishopTable[sq] : BlackBishopTable[sq];
+				if (bit_is_set(outposts, sq))
+				{
+					mg += sign * OutpostMg;
+					eg += sign * OutpostEg;
+				}
 			}
 
 			// Knights
@@ -97,8 +143,11 @@ namespace Evaluation
 				auto sq = pos.knight_list(color, i);
 				auto attacks = pos.knight_attacks(sq) & (~attack_bb[opposite_color(color)][PieceType::PAWN]);
 				attack_bb[color][PieceType::KNIGHT] |= attacks;
-				material[color] += KNIGHT_VAL;
-				material[color] += color == Color::WHITE ? WhiteKnightTable[sq] : BlackKnightTable[sq];
+				if (bit_is_set(outposts, sq))
+				{
+					mg += sign * OutpostMg;
+					eg += sign * OutpostEg;
+				}
 			}
 
 			// Rooks
@@ -107,8 +156,6 @@ namespace Evaluation
 				auto sq = pos.rook_list(color, i);
 				auto attacks = pos.rook_attacks(sq) & (~attack_bb[opposite_color(color)][PieceType::PAWN]);
 				attack_bb[color][PieceType::ROOK] |= attacks;
-				material[color] += ROOK_VAL;
-				material[color] += color == Color::WHITE ? WhiteRookTable[sq] : BlackRookTable[sq];
 			}
 
 			// Queens
@@ -117,26 +164,10 @@ namespace Evaluation
 				auto sq = pos.queen_list(color, i);
 				auto attacks = pos.queen_attacks(sq) & (~attack_bb[opposite_color(color)][PieceType::PAWN] | ~attack_bb[opposite_color(color)][PieceType::KNIGHT] | ~attack_bb[opposite_color(color)][PieceType::BISHOP] | ~attack_bb[opposite_color(color)][PieceType::ROOK]);
 				attack_bb[color][PieceType::QUEEN] |= attacks;
-				material[color] += QUEEN_VAL;
-				material[color] += color == Color::WHITE ? WhiteQueenTable[sq] : BlackQueenTable[sq];
 			}
 
 			// King
 			attack_bb[color][PieceType::KING] = pos.king_attacks(pos.king_square(color)) & (~attack_bb[opposite_color(color)][PieceType::PAWN] | ~attack_bb[opposite_color(color)][PieceType::KNIGHT] | ~attack_bb[opposite_color(color)][PieceType::BISHOP] | ~attack_bb[opposite_color(color)][PieceType::ROOK] | ~attack_bb[opposite_color(color)][PieceType::QUEEN]);
-
-			// If material has reduced significantly, the end game stage is reached
-			// The Kings should venture out to the middle
-			if (material[Color::WHITE] < 2000 && material[Color::BLACK] < 2000)
-			{
-				material[Color::WHITE] += WhiteKingEGTable[pos.king_square(Color::WHITE)];
-				material[Color::BLACK] += BlackKingEGTable[pos.king_square(Color::BLACK)];
-			}
-			else
-			{
-				material[Color::WHITE] += WhiteKingMGTable[pos.king_square(Color::WHITE)];
-				material[Color::BLACK] += BlackKingMGTable[pos.king_square(Color::BLACK)];
-			}
-
 		}
 
 		int influence[2];
@@ -150,36 +181,18 @@ namespace Evaluation
 			}
 		}
 
-		return double(material[Color::WHITE] - material[Color::BLACK]) + 10.0 * std::log(double(influence[Color::WHITE]) / double(influence[Color::BLACK]));
-	}
-
-	bool has_game_ended(Position& pos, int & result)
-	{
-		bool whiteToMove = (pos.side_to_move() == Color::WHITE);
-
-		// 50 moves / threefold repetition / insufficient material to mate -> draw
-		if (pos.is_draw())
-		{
-			result = 0;
-			return true;
-		}
-
-		if (pos.is_mate())
-		{
-			result = whiteToMove ? -mateEval : mateEval;
-			return true;
-		}
+		// 20 * (w - b) / (w + b) approximates the former 10 * log(w / b) mobility term
+		// without a transcendental call
+		const int total_influence = (std::max)(influence[Color::WHITE] + influence[Color::BLACK], 1);
+		const int mobility = 20 * (influence[Color::WHITE] - influence[Color::BLACK]) / total_influence;
 
-		Move mlist[256];
-		auto num_legal_moves = pos.all_legal_moves(mlist);
+		// the kings venture out to the middle as the material comes off the board
+		// endgames which are hard to win are scaled towards a draw for the side ahead
+		eg = apply_scale_factor(Value(eg), material->scale_factor(pos, eg > 0 ? WHITE : BLACK));
 
-		if (num_legal_moves == 0)
-		{
-			// Stalemate
-			result = 0;
-			return true;
-		}
+		const int phase = material->game_phase();
+		const int tapered = (mg * phase + eg * (PHASE_MIDGAME - phase)) / PHASE_MIDGAME;
 
-		return false;
+		return Value(tapered + mobility);
 	}
 }
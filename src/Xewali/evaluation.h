@@ -10,13 +10,14 @@
 #include <set>
 #include "Chess/position.h"
 #include "Chess/bitboard.h"
+#include "Xewali/material.h"
+#include "Xewali/pawns.h"
 
 using namespace Chess;
 
 namespace Evaluation
 {
 	/// Piece values
-	constexpr double mateEval = 1e6;
 	constexpr int KING_VAL = 20000;
 	constexpr int QUEEN_VAL = 900;
 	constexpr int ROOK_VAL = 500;
@@ -24,19 +25,17 @@ namespace Evaluation
 	constexpr int KNIGHT_VAL = 320;
 	constexpr int PAWN_VAL = 100;
 
-	/// Piece tables
-	constexpr int BlackPawnTable[64] =
-	{
-		0,  0,  0,  0,  0,  0,  0,  0,
-		50, 50, 50, 50, 50, 50, 50, 50,
-		10, 10, 20, 30, 30, 20, 10, 10,
-		5,  5, 10, 25, 25, 10,  5,  5,
-		0,  0,  0, 20, 20,  0,  0,  0,
-		5, -5,-10,  0,  0,-10, -5,  5,
-		5, 10, 10,-20,-20, 10, 10,  5,
-		0,  0,  0,  0,  0,  0,  0,  0
-	};
+	/// Piece values indexed by piece type
+	constexpr int PieceValues[8] = { 0, PAWN_VAL, KNIGHT_VAL, BISHOP_VAL, ROOK_VAL, QUEEN_VAL, KING_VAL, 0 };
 
+	/// Bonus of a knight or bishop on an outpost, a square in the enemy half defended
+	/// by a pawn of its own, which no enemy pawn can ever attack. Outposts are where
+	/// the evaluation uses the pawn attack spans cached in the pawn table.
+	constexpr int OutpostMg = 15;
+	constexpr int OutpostEg = 5;
+
+	/// Piece tables from white's point of view, indexed by square. Black's tables
+	/// are mirrored.
 	constexpr int WhitePawnTable[64] =
 	{
 		0,  0,  0,  0,  0,  0,  0,  0,
@@ -49,18 +48,6 @@ namespace Evaluation
 		0,  0,  0,  0,  0,  0,  0,  0
 	};
 
-	constexpr int BlackKnightTable[64] =
-	{
-		-50,-40,-30,-30,-30,-30,-40,-50,
-		-40,-20,  0,  0,  0,  0,-20,-40,
-		-30,  0, 10, 15, 15, 10,  0,-30,
-		-30,  5, 15, 20, 20, 15,  5,-30,
-		-30,  0, 15, 20, 20, 15,  0,-30,
-		-30,  5, 10, 15, 15, 10,  5,-30,
-		-40,-20,  0,  5,  5,  0,-20,-40,
-		-50,-40,-30,-30,-30,-30,-40,-50
-	};
-
 	constexpr int WhiteKnightTable[64] =
 	{
 		-50,-40,-30,-30,-30,-30,-40,-50,
@@ -73,18 +60,6 @@ namespace Evaluation
 		-50,-40,-30,-30,-30,-30,-40,-50
 	};
 
-	constexpr int BlackBishopTable[64] =
-	{
-		-20,-10,-10,-10,-10,-10,-10,-20,
-		-10,  0,  0,  0,  0,  0,  0,-10,
-		-10,  0,  5, 10, 10,  5,  0,-10,
-		-10,  5,  5, 10, 10,  5,  5,-10,
-		-10,  0, 10, 10, 10, 10,  0,-10,
-		-10, 10, 10, 10, 10, 10, 10,-10,
-		-10,  5,  0,  0,  0,  0,  5,-10,
-		-20,-10,-10,-10,-10,-10,-10,-20
-	};
-
 	constexpr int WhiteBishopTable[64] =
 	{
 		-20,-10,-10,-10,-10,-10,-10,-20,
@@ -97,18 +72,6 @@ namespace Evaluation
 		-20,-10,-10,-10,-10,-10,-10,-20
 	};
 
-	constexpr int BlackRookTable[64] =
-	{
-		0,  0,  0,  0,  0,  0,  0,  0,
-		5, 10, 10, 10, 10, 10, 10,  5,
-		-5,  0,  0,  0,  0,  0,  0, -5,
-		-5,  0,  0,  0,  0,  0,  0, -5,
-		-5,  0,  0,  0,  0,  0,  0, -5,
-		-5,  0,  0,  0,  0,  0,  0, -5,
-		-5,  0,  0,  0,  0,  0,  0, -5,
-		0,  0,  0,  5,  5,  0,  0,  0
-	};
-
 	constexpr int WhiteRookTable[64] =
 	{
 		0,  0,  0,  5,  5,  0,  0,  0,
@@ -121,18 +84,6 @@ namespace Evaluation
 		0,  0,  0,  0,  0,  0,  0,  0
 	};
 
-	constexpr int BlackQueenTable[64] =
-	{
-		-20,-10,-10, -5, -5,-10,-10,-20,
-		-10,  0,  0,  0,  0,  0,  0,-10,
-		-10,  0,  5,  5,  5,  5,  0,-10,
-		-5,  0,  5,  5,  5,  5,  0, -5,
-		 0,  0,  5,  5,  5,  5,  0, -5,
-		-10,  5,  5,  5,  5,  5,  0,-10,
-		-10,  0,  5,  0,  0,  0,  0,-10,
-		-20,-10,-10, -5, -5,-10,-10,-20
-	};
-
 	constexpr int WhiteQueenTable[64] =
 	{
 		-20,-10,-10, -5, -5,-10,-10,-20,
@@ -145,18 +96,6 @@ namespace Evaluation
 		-20,-10,-10, -5, -5,-10,-10,-20
 	};
 
-	constexpr int BlackKingMGTable[64] =
-	{
-		-30,-40,-40,-50,-50,-40,-40,-30,
-		-30,-40,-40,-50,-50,-40,-40,-30,
-		-30,-40,-40,-50,-50,-40,-40,-30,
-		-30,-40,-40,-50,-50,-40,-40,-30,
-		-20,-30,-30,-40,-40,-30,-30,-20,
-		-10,-20,-20,-20,-20,-20,-20,-10,
-		20, 20,  0,  0,  0,  0, 20, 20,
-		20, 30, 10,  0,  0, 10, 30, 20
-	};
-
 	constexpr int WhiteKingMGTable[64] =
 	{
 		20, 30, 10,  0,  0, 10, 30, 20,
@@ -169,18 +108,6 @@ namespace Evaluation
 		-30,-40,-40,-50,-50,-40,-40,-30
 	};
 
-	constexpr int BlackKingEGTable[64] =
-	{
-		-50,-40,-30,-20,-20,-30,-40,-50,
-		-30,-20,-10,  0,  0,-10,-20,-30,
-		-30,-10, 20, 30, 30, 20,-10,-30,
-		-30,-10, 30, 40, 40, 30,-10,-30,
-		-30,-10, 30, 40, 40, 30,-10,-30,
-		-30,-10, 20, 30, 30, 20,-10,-30,
-		-30,-30,  0,  0,  0,  0,-30,-30,
-		-50,-30,-30,-30,-30,-30,-30,-50
-	};
-
 	constexpr int WhiteKingEGTable[64] =
 	{
 		-50,-30,-30,-30,-30,-30,-30,-50,
@@ -197,15 +124,19 @@ namespace Evaluation
 
 	void load_games(Book& book, const std::string& game_file);
 
-	/// Evaluates the position using material, piece tables adn mobility
-	/// @param[in] pos The position
-	/// return The evaluation
-	double eval(Position& pos);
+	/// Installs the piece values and piece tables as the piece square tables of
+	/// Position, so that material and placement are updated incrementally with
+	/// every move. Must be called before any position is set up.
+	void init();
 
-	/// Checks if the game has ended in a win/loss or draw
+	/// Evaluates the position using material, piece tables, pawn structure, king
+	/// shelter, outposts and mobility. Middle game and endgame scores are blended
+	/// by the game phase.
+	/// Checkmate and stalemate are not recognized, they are left to the search.
 	/// @param[in] pos The position
-	/// @param[out] result the result of the game (1, -1, 0) if the game has ended
-	/// return true if the game has ended, false otherwise
-	bool has_game_ended(Position& pos, int& result);
+	/// @param[in] pawn_table The pawn structures evaluated so far by the calling thread
+	/// @param[in] material_table The material signatures analysed so far by the calling thread
+	/// return The evaluation in centipawns from white's point of view
+	Value eval(Position& pos, Pawns::Table& pawn_table, Material::Table& material_table);
 };
 
@@ -0,0 +1,137 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#include "Xewali/material.h"
+
+namespace Material
+{
+	namespace
+	{
+		/// Bonus for the pair of bishops, middle game and endgame
+		constexpr int BishopPairMg = 30;
+		constexpr int BishopPairEg = 50;
+
+		/// Knights gain and rooks lose value with every own pawn above five
+		constexpr int KnightPawnAdjustment = 4;
+		constexpr int RookPawnAdjustment = -8;
+	}
+
+	Value Entry::evaluate(const Position& pos) const
+	{
+		const Value eval = evaluation_function(pos, strong_side);
+		return strong_side == WHITE ? eval : -eval;
+	}
+
+	ScaleFactor Entry::scale_factor(const Position& pos, Color c) const
+	{
+		if (scaling_function[c])
+		{
+			const ScaleFactor sf = scaling_function[c](pos, c);
+			if (sf != SCALE_FACTOR_NONE)
+			{
+				return sf;
+			}
+		}
+		return factor[c];
+	}
+
+	Table::Table()
+		: entries(new Entry[TableSize])
+	{
+	}
+
+	Entry* Table::probe(const Position& pos)
+	{
+		const Key key = pos.get_material_key();
+		Entry* e = &entries[key & (TableSize - 1)];
+		probe_count++;
+
+		if (e->key == key)
+		{
+			hit_count++;
+			return e;
+		}
+
+		analyse(pos, *e);
+		e->key = key;
+		return e;
+	}
+
+	void Table::analyse(const Position& pos, Entry& e)
+	{
+		e = Entry();
+
+		// the phase only depends on the non pawn material
+		e.phase = pos.game_phase();
+
+		const Value npm[2] = { pos.non_pawn_material(WHITE), pos.non_pawn_material(BLACK) };
+
+		// a single minor piece at most, nobody can mate
+		if (!pos.pawns() && npm[WHITE] + npm[BLACK] <= BishopValueMidgame)
+		{
+			e.draw = true;
+			return;
+		}
+
+		for (Color c = WHITE; c <= BLACK; c++)
+		{
+			const Color them = opposite_color(c);
+			const int pawns = pos.pawn_count(c);
+			const int knights = pos.knight_count(c);
+			const int bishops = pos.bishop_count(c);
+			const int rooks = pos.rook_count(c);
+			const int queens = pos.queen_count(c);
+			const bool bare_opponent = npm[them] == 0 && pos.pawn_count(them) == 0;
+			const bool knights_only = knights == 2 && bishops + rooks + queens == 0 && pawns == 0;
+
+			// specialized evaluations against the bare king
+			if (bare_opponent && pawns == 0 && knights == 1 && bishops == 1 && rooks + queens == 0)
+			{
+				e.evaluation_function = Endgames::kbnk;
+				e.strong_side = c;
+			}
+			else if (bare_opponent && npm[c] >= RookValueMidgame && !knights_only)
+			{
+				e.evaluation_function = Endgames::kxk;
+				e.strong_side = c;
+			}
+
+			// without pawns, a side up by less than a rook can hardly win
+			if (pawns == 0 && npm[c] - npm[them] <= BishopValueMidgame)
+			{
+				e.factor[c] = npm[c] < RookValueMidgame ? SCALE_FACTOR_ZERO
+					: npm[them] <= BishopValueMidgame ? ScaleFactor(4) : ScaleFactor(14);
+			}
+			if (knights_only && bare_opponent)
+			{
+				e.factor[c] = SCALE_FACTOR_ZERO;
+			}
+
+			// pawns on a rook file are drawn if the weak king gets in front of them
+			if (bare_opponent && pawns > 0 && rooks + queens + knights == 0 && bishops <= 1)
+			{
+				e.scaling_function[c] = bishops == 1 ? Endgames::kbpsk : Endgames::kpsk;
+			}
+
+			// piece imbalance
+			const int sign = c == WHITE ? 1 : -1;
+			if (bishops >= 2)
+			{
+				e.mg += sign * BishopPairMg;
+				e.eg += sign * BishopPairEg;
+			}
+			const int adjustment = (pawns - 5) * (knights * KnightPawnAdjustment + rooks * RookPawnAdjustment);
+			e.mg += sign * adjustment;
+			e.eg += sign * adjustment;
+		}
+
+		// bishops of opposite colors, decided by the position once the entry is used
+		if (pos.bishop_count(WHITE) == 1 && pos.bishop_count(BLACK) == 1
+			&& npm[WHITE] == BishopValueMidgame && npm[BLACK] == BishopValueMidgame)
+		{
+			e.scaling_function[WHITE] = e.scaling_function[BLACK] = Endgames::opposite_bishops;
+		}
+	}
+}
@@ -0,0 +1,92 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include "Chess/phase.h"
+#include "Chess/position.h"
+#include "Chess/scale.h"
+#include "Xewali/endgames.h"
+
+using namespace Chess;
+
+namespace Material
+{
+	/// Number of entries in a material table, a power of two
+	constexpr int TableSize = 8192;
+
+	/// Everything the evaluation derives from the material signature alone, i.e.
+	/// from the number of pieces of every type on the board. Scores are from
+	/// white's point of view.
+	class Entry
+	{
+	public:
+		/// @return the game phase, PHASE_MIDGAME with all pieces on the board
+		Phase game_phase() const { return phase; }
+
+		/// @return the middle game score of the piece combination
+		int imbalance_mg() const { return mg; }
+
+		/// @return the endgame score of the piece combination
+		int imbalance_eg() const { return eg; }
+
+		/// @return true if neither side can ever mate
+		bool is_draw() const { return draw; }
+
+		/// @return true if the endgame has a specialized evaluation
+		bool has_evaluation_function() const { return evaluation_function != nullptr; }
+
+		/// Evaluates a position with the specialized evaluation of the endgame
+		/// @return the evaluation from white's point of view
+		Value evaluate(const Position& pos) const;
+
+		/// The factor the endgame score of a side is scaled with
+		/// @param[in] pos The position, it must have the material of the entry
+		/// @param[in] c The side
+		/// @return the scale factor, SCALE_FACTOR_NORMAL if the score is not scaled
+		ScaleFactor scale_factor(const Position& pos, Color c) const;
+
+	private:
+		friend class Table;
+
+		Key key = 0;
+		Phase phase = PHASE_MIDGAME;
+		int mg = 0;
+		int eg = 0;
+		bool draw = false;
+		ScaleFactor factor[2] = { SCALE_FACTOR_NORMAL, SCALE_FACTOR_NORMAL };
+		Endgames::ScalingFunction scaling_function[2] = { nullptr, nullptr };
+		Endgames::EvaluationFunction evaluation_function = nullptr;
+		Color strong_side = WHITE;
+	};
+
+	/// A hash table of material signatures indexed by the material key of the
+	/// position. Every search thread has its own table.
+	class Table
+	{
+	public:
+		Table();
+
+		/// Finds the entry of the position's material, analysing the material if it
+		/// is not in the table
+		/// @param[in] pos The position
+		/// @return the entry, valid until the next probe
+		Entry* probe(const Position& pos);
+
+		/// @return the number of probes since the table was created
+		uint64_t probes() const { return probe_count; }
+
+		/// @return the number of probes which found their material signature
+		uint64_t hits() const { return hit_count; }
+
+	private:
+		static void analyse(const Position& pos, Entry& e);
+
+		std::unique_ptr<Entry[]> entries;
+		uint64_t probe_count = 0;
+		uint64_t hit_count = 0;
+	};
+}
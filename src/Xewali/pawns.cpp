@@ -0,0 +1,149 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#include "Xewali/pawns.h"
+
+namespace Pawns
+{
+	namespace
+	{
+		/// Penalties of weak pawns, middle game and endgame
+		constexpr int DoubledMg = 10, DoubledEg = 20;
+		constexpr int IsolatedMg = 10, IsolatedEg = 15;
+		constexpr int BackwardMg = 8, BackwardEg = 10;
+
+		/// Bonus of a passed pawn by its rank from its own side
+		constexpr int PassedMg[8] = { 0, 0, 5, 10, 20, 35, 60, 0 };
+		constexpr int PassedEg[8] = { 0, 5, 10, 20, 40, 70, 110, 0 };
+
+		/// Bonus of a pawn shielding the king one and two ranks in front of it
+		constexpr int ShieldNear = 12;
+		constexpr int ShieldFar = 6;
+
+		Bitboard pawn_attacks_bb(Color c, Bitboard pawns)
+		{
+			return c == WHITE
+				? ((pawns & ~FileABB) << 7) | ((pawns & ~FileHBB) << 9)
+				: ((pawns & ~FileABB) >> 9) | ((pawns & ~FileHBB) >> 7);
+		}
+	}
+
+	int Entry::king_shelter(const Position& pos, Color c)
+	{
+		const Square ksq = pos.king_square(c);
+		if (king_squares[c] == ksq)
+		{
+			return shelter[c];
+		}
+
+		// the pawns on the king's file and the files next to it, on the two ranks in front of it
+		const Bitboard files = this_and_neighboring_files_bb(ksq);
+		const Bitboard pawns = pos.pawns(c) & files & in_front_bb(c, ksq);
+		const Rank rank = pawn_rank(c, ksq);
+		int bonus = 0;
+		if (rank < RANK_8)
+		{
+			bonus += ShieldNear * count_1s(pawns & relative_rank_bb(c, Rank(rank + 1)));
+		}
+		if (rank < RANK_7)
+		{
+			bonus += ShieldFar * count_1s(pawns & relative_rank_bb(c, Rank(rank + 2)));
+		}
+
+		king_squares[c] = ksq;
+		shelter[c] = bonus;
+		return bonus;
+	}
+
+	Table::Table()
+		: entries(new Entry[TableSize])
+	{
+	}
+
+	Entry* Table::probe(const Position& pos)
+	{
+		const Key key = pos.get_pawn_key();
+		Entry* e = &entries[key & (TableSize - 1)];
+		probe_count++;
+
+		if (e->key == key)
+		{
+			hit_count++;
+			return e;
+		}
+
+		evaluate(pos, *e);
+		e->key = key;
+		return e;
+	}
+
+	void Table::evaluate(const Position& pos, Entry& e)
+	{
+		e.king_squares[WHITE] = e.king_squares[BLACK] = SQ_NONE;
+
+		for (Color c = WHITE; c <= BLACK; c++)
+		{
+			e.attacks[c] = pawn_attacks_bb(c, pos.pawns(c));
+			e.span[c] = EmptyBoardBB;
+			e.passed[c] = EmptyBoardBB;
+		}
+
+		int score[2][2] = { { 0, 0 }, { 0, 0 } };
+
+		for (Color c = WHITE; c <= BLACK; c++)
+		{
+			const Color them = opposite_color(c);
+			const Bitboard ours = pos.pawns(c);
+			int& mg = score[c][0];
+			int& eg = score[c][1];
+
+			for (int i = 0; i < pos.pawn_count(c); i++)
+			{
+				const Square sq = pos.pawn_list(c, i);
+				const Square stop = c == WHITE ? Square(sq + 8) : Square(sq - 8);
+
+				// the squares on the files next to the pawn in front of it
+				e.span[c] |= outpost_mask(c, sq);
+
+				const bool isolated = pos.pawn_is_isolated(c, sq);
+				const bool doubled = pos.pawn_is_doubled(c, sq);
+
+				// a pawn no pawn of its own can defend as it advances, whose stop square
+				// is held by an enemy pawn
+				const bool backward = !isolated
+					&& !(ours & neighboring_files_bb(sq) & ~in_front_bb(c, sq))
+					&& bit_is_set(e.attacks[them], stop);
+
+				// the frontmost pawn on the file, with no enemy pawn in front of it or next to it
+				const bool passed = pos.pawn_is_passed(c, sq) && !(ours & squares_in_front_of(c, sq));
+
+				if (doubled)
+				{
+					mg -= DoubledMg;
+					eg -= DoubledEg;
+				}
+				if (isolated)
+				{
+					mg -= IsolatedMg;
+					eg -= IsolatedEg;
+				}
+				if (backward)
+				{
+					mg -= BackwardMg;
+					eg -= BackwardEg;
+				}
+				if (passed)
+				{
+					set_bit(&e.passed[c], sq);
+					mg += PassedMg[pawn_rank(c, sq)];
+					eg += PassedEg[pawn_rank(c, sq)];
+				}
+			}
+		}
+
+		e.mg = score[WHITE][0] - score[BLACK][0];
+		e.eg = score[WHITE][1] - score[BLACK][1];
+	}
+}
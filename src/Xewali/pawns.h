@@ -0,0 +1,86 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include "Chess/position.h"
+
+using namespace Chess;
+
+namespace Pawns
+{
+	/// Number of entries in a pawn table, a power of two
+	constexpr int TableSize = 16384;
+
+	/// The evaluation of a pawn structure. Everything but the king shelter only
+	/// depends on the pawns, so it is computed once per pawn structure and shared
+	/// by all positions with the same pawns. Scores are from white's point of view.
+	class Entry
+	{
+	public:
+		/// @return the middle game score of the pawn structure
+		int mg_value() const { return mg; }
+
+		/// @return the endgame score of the pawn structure
+		int eg_value() const { return eg; }
+
+		/// @return the passed pawns of a side
+		Bitboard passed_pawns(Color c) const { return passed[c]; }
+
+		/// @return the squares attacked by the pawns of a side
+		Bitboard pawn_attacks(Color c) const { return attacks[c]; }
+
+		/// @return the squares the pawns of a side attack now or may attack once they advance
+		Bitboard attack_span(Color c) const { return span[c]; }
+
+		/// The bonus of a side for the pawns in front of its king. It is computed on
+		/// the first call for a king square and kept until the king moves.
+		/// @param[in] pos The position, it must have the pawns of the entry
+		/// @param[in] c The side
+		/// @return the middle game bonus in centipawns
+		int king_shelter(const Position& pos, Color c);
+
+	private:
+		friend class Table;
+
+		Key key = 0;
+		int mg = 0;
+		int eg = 0;
+		Bitboard passed[2] = { EmptyBoardBB, EmptyBoardBB };
+		Bitboard attacks[2] = { EmptyBoardBB, EmptyBoardBB };
+		Bitboard span[2] = { EmptyBoardBB, EmptyBoardBB };
+		Square king_squares[2] = { SQ_NONE, SQ_NONE };
+		int shelter[2] = { 0, 0 };
+	};
+
+	/// A hash table of pawn structures indexed by the pawn key of the position. Every
+	/// search thread has its own table, so that no locking is needed. As the pawns
+	/// rarely change within a search tree, almost every probe is a hit.
+	class Table
+	{
+	public:
+		Table();
+
+		/// Finds the entry of the position's pawn structure, evaluating the pawns if the
+		/// structure is not in the table
+		/// @param[in] pos The position
+		/// @return the entry, valid until the next probe
+		Entry* probe(const Position& pos);
+
+		/// @return the number of probes since the table was created
+		uint64_t probes() const { return probe_count; }
+
+		/// @return the number of probes which found their pawn structure
+		uint64_t hits() const { return hit_count; }
+
+	private:
+		static void evaluate(const Position& pos, Entry& e);
+
+		std::unique_ptr<Entry[]> entries;
+		uint64_t probe_count = 0;
+		uint64_t hit_count = 0;
+	};
+}
@@ -0,0 +1,82 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#include <algorithm>
+#include "Xewali/time_manager.h"
+
+namespace TimeManagement
+{
+	namespace
+	{
+		// the maximum time is at most this multiple of the optimum time
+		constexpr int MaxRatio = 5;
+
+		// the optimum time is extended by at most this factor while the best move is unstable
+		constexpr double MaxExtension = 2.0;
+	}
+
+	void TimeManager::start(int time_left, int increment, int moves_to_go, int move_time, int move_overhead)
+	{
+		start_time = std::chrono::steady_clock::now().time_since_epoch().count();
+		instability = 0.;
+
+		if (move_time > 0)
+		{
+			timed = true;
+			optimum = maximum = (std::max)(move_time - move_overhead, 1);
+			return;
+		}
+
+		timed = time_left > 0;
+		if (!timed)
+		{
+			return;
+		}
+
+		const int usable = (std::max)(time_left - move_overhead, 1);
+		const int moves = moves_to_go > 0 ? (std::min)(moves_to_go, 50) : DefaultMovesToGo;
+
+		// an equal share of the remaining time plus most of the increment, but never
+		// so much that the clock runs low before the time control
+		optimum = (std::min)(usable / moves + increment * 3 / 4, usable / 2);
+		maximum = (std::min)(optimum * MaxRatio, usable * 3 / 4);
+		optimum = (std::max)(optimum, 1);
+		maximum = (std::max)(maximum, optimum);
+	}
+
+	void TimeManager::ponderhit()
+	{
+		start_time = std::chrono::steady_clock::now().time_since_epoch().count();
+	}
+
+	int TimeManager::elapsed() const
+	{
+		const std::chrono::steady_clock::duration since_start(std::chrono::steady_clock::now().time_since_epoch().count() - start_time.load());
+		return int(std::chrono::duration_cast<std::chrono::milliseconds>(since_start).count());
+	}
+
+	void TimeManager::iteration_completed(bool best_move_changed)
+	{
+		instability = instability / 2 + (best_move_changed ? 1. : 0.);
+	}
+
+	bool TimeManager::soft_limit_reached() const
+	{
+		if (!timed)
+		{
+			return false;
+		}
+
+		// the next iteration takes longer than all previous ones together, so it is
+		// not started once more than half of the time is used up
+		const double extension = (std::min)(1. + instability / 2, MaxExtension);
+		return elapsed() > (std::min)(optimum * extension, double(maximum)) / 2;
+	}
+
+	bool TimeManager::hard_limit_reached() const
+	{
+		return timed && elapsed() >= maximum;
+	}
+}
@@ -0,0 +1,62 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#pragma once
+#include <atomic>
+#include <chrono>
+
+namespace TimeManagement
+{
+	/// Default time in ms reserved per move for the communication with the GUI
+	constexpr int DefaultMoveOverhead = 30;
+
+	/// Number of moves the remaining time is divided into if the GUI does not tell
+	constexpr int DefaultMovesToGo = 30;
+
+	/// Decides how long a search may take. Time is measured on the wall clock,
+	/// as CPU time adds up over all search threads.
+	/// The optimum time is the time after which no new iteration is started. It is
+	/// extended while the best move keeps changing between iterations. The maximum
+	/// time is a hard limit at which a running iteration is aborted.
+	class TimeManager
+	{
+	public:
+		/// Starts the clock for a new search
+		/// @param[in] time_left The time left on the clock in ms, 0 if the search is not timed
+		/// @param[in] increment The increment per move in ms
+		/// @param[in] moves_to_go The number of moves to the next time control, 0 if unknown
+		/// @param[in] move_time A fixed time for the move in ms, 0 if none
+		/// @param[in] move_overhead The time in ms kept in reserve for the communication
+		void start(int time_left, int increment, int moves_to_go, int move_time, int move_overhead);
+
+		/// Restarts the clock, so that a search which has been pondering gets its full
+		/// time once the opponent has played the expected move. May be called while the
+		/// search is running.
+		void ponderhit();
+
+		/// @return the time in ms since the search has started
+		int elapsed() const;
+
+		/// Registers a completed iteration
+		/// @param[in] best_move_changed Whether the iteration has changed the best move
+		void iteration_completed(bool best_move_changed);
+
+		/// @return true if no new iteration should be started
+		bool soft_limit_reached() const;
+
+		/// @return true if the search must be stopped at once
+		bool hard_limit_reached() const;
+
+	private:
+		// the start time in clock ticks, atomic as a ponderhit moves it during the search
+		std::atomic<std::chrono::steady_clock::rep> start_time{ 0 };
+		bool timed = false;
+		int optimum = 0;
+		int maximum = 0;
+
+		// grows with every change of the best move and decays with every stable iteration
+		double instability = 0.;
+	};
+}
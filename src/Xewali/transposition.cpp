@@ -0,0 +1,216 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#include <algorithm>
+#include <limits>
+#include "Xewali/transposition.h"
+
+namespace Transposition
+{
+	namespace
+	{
+		inline uint16_t key_bits(Key key)
+		{
+			return uint16_t(key >> 48);
+		}
+
+		// Generations are counted in the upper 6 bits of the generation/bound byte
+		constexpr int GenerationStep = 4;
+		constexpr uint8_t GenerationMask = 0xFC;
+
+		// Weight of one generation of age against one ply of depth when
+		// choosing the entry to replace
+		constexpr int AgeWeight = 8;
+
+		// Castling moves never promote, so the castle flag is packed as the
+		// otherwise unused promotion type 7 to keep moves within 16 bits
+		constexpr int CastlePromotion = 7;
+
+		inline uint16_t pack_move(Move move)
+		{
+			if (move_is_castle(move))
+			{
+				return uint16_t((int(move) & 0xFFF) | (CastlePromotion << 12));
+			}
+			return uint16_t(move);
+		}
+
+		inline Move unpack_move(uint16_t move)
+		{
+			if (((move >> 12) & 7) == CastlePromotion)
+			{
+				return make_castle_move(Square((move >> 6) & 077), Square(move & 077));
+			}
+			return Move(move);
+		}
+
+		inline uint64_t pack(Key key, Move move, Value score, int depth, uint8_t gen_bound)
+		{
+			return (uint64_t(key_bits(key)) << 48)
+				| (uint64_t(pack_move(move)) << 32)
+				| (uint64_t(uint16_t(int16_t(score))) << 16)
+				| (uint64_t(uint8_t(depth)) << 8)
+				| gen_bound;
+		}
+
+		inline Move unpack_move(uint64_t data)
+		{
+			return unpack_move(uint16_t(data >> 32));
+		}
+
+		inline Value unpack_score(uint64_t data)
+		{
+			return Value(int16_t(uint16_t(data >> 16)));
+		}
+
+		inline int unpack_depth(uint64_t data)
+		{
+			return int((data >> 8) & 0xFF);
+		}
+
+		inline uint8_t unpack_generation(uint64_t data)
+		{
+			return uint8_t(data) & GenerationMask;
+		}
+
+		inline ValueType unpack_bound(uint64_t data)
+		{
+			return ValueType(data & 3);
+		}
+
+		inline uint64_t with_generation(uint64_t data, uint8_t generation)
+		{
+			return (data & ~uint64_t(GenerationMask)) | generation;
+		}
+	}
+
+	Table::Table(std::size_t mb)
+	{
+		resize(mb);
+	}
+
+	void Table::resize(std::size_t mb)
+	{
+		std::size_t count = 1;
+		while (2 * count * sizeof(Cluster) <= mb * 1024 * 1024)
+		{
+			count *= 2;
+		}
+
+		if (count != cluster_count)
+		{
+			clusters.reset(new Cluster[count]);
+			cluster_count = count;
+		}
+		clear();
+	}
+
+	void Table::clear()
+	{
+		for (std::size_t i = 0; i < cluster_count; i++)
+		{
+			for (auto& e : clusters[i].entry)
+			{
+				e.store(0, std::memory_order_relaxed);
+			}
+		}
+		generation = 0;
+	}
+
+	void Table::new_search()
+	{
+		generation += GenerationStep;
+	}
+
+	int Table::hashfull() const
+	{
+		const std::size_t sample = (std::min)(std::size_t(1000 / ClusterSize), cluster_count);
+		int used = 0;
+		for (std::size_t i = 0; i < sample; i++)
+		{
+			for (const auto& e : clusters[i].entry)
+			{
+				uint64_t data = e.load(std::memory_order_relaxed);
+				if (data != 0 && unpack_generation(data) == generation)
+				{
+					used++;
+				}
+			}
+		}
+		return int(used * 1000 / (sample * ClusterSize));
+	}
+
+	Cluster* Table::cluster_of(Key key) const
+	{
+		return &clusters[key & (cluster_count - 1)];
+	}
+
+	bool Table::probe(Key key, Entry& entry)
+	{
+		Cluster* cluster = cluster_of(key);
+		const uint16_t bits = key_bits(key);
+
+		for (auto& e : cluster->entry)
+		{
+			uint64_t data = e.load(std::memory_order_relaxed);
+			if (data != 0 && uint16_t(data >> 48) == bits)
+			{
+				// keep entries still in use from being replaced as old ones
+				if (unpack_generation(data) != generation)
+				{
+					e.store(with_generation(data, generation), std::memory_order_relaxed);
+				}
+				entry.move = unpack_move(data);
+				entry.score = unpack_score(data);
+				entry.depth = unpack_depth(data);
+				entry.bound = unpack_bound(data);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void Table::store(Key key, int depth, ValueType bound, Value score, Move move)
+	{
+		Cluster* cluster = cluster_of(key);
+		const uint16_t bits = key_bits(key);
+		std::atomic<uint64_t>* replace = &cluster->entry[0];
+		int replace_worth = (std::numeric_limits<int>::max)();
+
+		for (auto& e : cluster->entry)
+		{
+			uint64_t data = e.load(std::memory_order_relaxed);
+
+			// empty slot
+			if (data == 0)
+			{
+				replace = &e;
+				break;
+			}
+
+			// the same position, keep its move if no new one is known
+			if (uint16_t(data >> 48) == bits)
+			{
+				if (move == MOVE_NONE)
+				{
+					move = unpack_move(data);
+				}
+				replace = &e;
+				break;
+			}
+
+			// otherwise replace the oldest and shallowest entry
+			const int age = uint8_t(generation - unpack_generation(data)) / GenerationStep;
+			const int worth = unpack_depth(data) - AgeWeight * age;
+			if (worth < replace_worth)
+			{
+				replace = &e;
+				replace_worth = worth;
+			}
+		}
+
+		replace->store(pack(key, move, score, depth, uint8_t(generation | bound)), std::memory_order_relaxed);
+	}
+}
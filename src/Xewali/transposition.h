@@ -0,0 +1,93 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "Chess/move.h"
+#include "Chess/types.h"
+#include "Chess/value.h"
+
+using namespace Chess;
+
+namespace Transposition
+{
+	/// Default size of the transposition table in MB
+	constexpr std::size_t DefaultSizeMB = 16;
+
+	/// Largest size of the transposition table in MB which can be configured
+	constexpr std::size_t MaxSizeMB = 32768;
+
+	/// Number of entries in a cluster. A cluster fills exactly one cache line.
+	constexpr int ClusterSize = 8;
+
+	/// Every entry is packed into a single 64 bit word, so that a store or a probe
+	/// is one atomic memory access and the table can be shared between threads
+	/// without a mutex. The layout of an entry is
+	/// [ key verification (16) | move (16) | score (16) | depth (8) | generation (6) | bound (2) ]
+	/// An all-zero word marks an empty entry.
+	struct alignas(64) Cluster
+	{
+		std::atomic<uint64_t> entry[ClusterSize];
+	};
+
+	/// The unpacked contents of an entry
+	struct Entry
+	{
+		Move move = MOVE_NONE;
+		Value score = VALUE_NONE;
+		int depth = 0;
+		ValueType bound = VALUE_TYPE_NONE;
+	};
+
+	/// A fixed-size hash table indexed by the zobrist key of a position.
+	/// The number of clusters is always a power of two.
+	/// The table lives for the whole game. Every search starts a new generation,
+	/// and entries left over from older searches are the first to be replaced.
+	class Table
+	{
+	public:
+		explicit Table(std::size_t mb = DefaultSizeMB);
+
+		/// Reallocates the table to the largest power of two number of clusters
+		/// fitting into the given size. The contents are cleared.
+		/// @param[in] mb The size of the table in MB
+		void resize(std::size_t mb);
+
+		/// Empties all entries and resets the generation
+		void clear();
+
+		/// Starts a new generation, to be called once at the start of every search
+		void new_search();
+
+		/// Estimates how full the table is from a sample of its first entries
+		/// @return the permille of entries written or used by the current search
+		int hashfull() const;
+
+		/// Looks up a position in the table. A hit refreshes the generation of the entry.
+		/// @param[in] key The zobrist key of the position
+		/// @param[out] entry The stored move, score, depth and bound
+		/// @return true if the position was found, false otherwise
+		bool probe(Key key, Entry& entry);
+
+		/// Stores the evaluation of a position. An entry of the same position is
+		/// overwritten, otherwise the entry with the oldest generation and the
+		/// lowest depth is replaced.
+		/// @param[in] key The zobrist key of the position
+		/// @param[in] depth The depth the position was evaluated at
+		/// @param[in] bound Whether the score is exact, a lower or an upper bound
+		/// @param[in] score The evaluation, mate scores relative to the position
+		/// @param[in] move The best move, MOVE_NONE keeps a previously stored move
+		void store(Key key, int depth, ValueType bound, Value score, Move move);
+
+	private:
+		Cluster* cluster_of(Key key) const;
+
+		std::unique_ptr<Cluster[]> clusters;
+		std::size_t cluster_count = 0;
+		uint8_t generation = 0;
+	};
+}
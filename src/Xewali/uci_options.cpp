@@ -0,0 +1,188 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include "Xewali/uci_options.h"
+
+namespace UciOptions
+{
+	namespace
+	{
+		bool equal_ignoring_case(const std::string& a, const std::string& b)
+		{
+			return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y)
+			{
+				return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+			});
+		}
+	}
+
+	Option::Option(bool default_value, OnChange on_change)
+		: type(OptionType::Check), default_value(default_value ? "true" : "false"), on_change(on_change)
+	{
+		value = this->default_value;
+	}
+
+	Option::Option(int default_value, int min, int max, OnChange on_change)
+		: type(OptionType::Spin), default_value(std::to_string(default_value)), min(min), max(max), on_change(on_change)
+	{
+		value = this->default_value;
+	}
+
+	Option::Option(const std::string& default_value, const std::vector<std::string>& variants, OnChange on_change)
+		: type(OptionType::Combo), default_value(default_value), variants(variants), on_change(on_change)
+	{
+		value = this->default_value;
+	}
+
+	Option::Option(const std::string& default_value, OnChange on_change)
+		: type(OptionType::String), default_value(default_value), on_change(on_change)
+	{
+		value = this->default_value;
+	}
+
+	Option::Option(const char* default_value, OnChange on_change)
+		: Option(std::string(default_value), on_change)
+	{
+	}
+
+	bool Option::set(const std::string& new_value)
+	{
+		switch (type)
+		{
+		case OptionType::Check:
+			if (new_value != "true" && new_value != "false")
+			{
+				return false;
+			}
+			value = new_value;
+			break;
+
+		case OptionType::Spin:
+		{
+			char* end = nullptr;
+			const long number = std::strtol(new_value.c_str(), &end, 10);
+			if (new_value.empty() || *end != '\0')
+			{
+				return false;
+			}
+			value = std::to_string((std::max)(long(min), (std::min)(number, long(max))));
+			break;
+		}
+
+		case OptionType::Combo:
+		{
+			auto variant = std::find_if(variants.begin(), variants.end(), [&new_value](const std::string& v)
+			{
+				return equal_ignoring_case(v, new_value);
+			});
+			if (variant == variants.end())
+			{
+				return false;
+			}
+			value = *variant;
+			break;
+		}
+
+		case OptionType::String:
+			value = new_value == "<empty>" ? "" : new_value;
+			break;
+		}
+
+		if (on_change)
+		{
+			on_change(*this);
+		}
+		return true;
+	}
+
+	bool Option::as_bool() const
+	{
+		assert(type == OptionType::Check);
+		return value == "true";
+	}
+
+	int Option::as_int() const
+	{
+		assert(type == OptionType::Spin);
+		return std::atoi(value.c_str());
+	}
+
+	const std::string& Option::as_string() const
+	{
+		assert(type == OptionType::Combo || type == OptionType::String);
+		return value;
+	}
+
+	void Option::print(std::ostream& out) const
+	{
+		switch (type)
+		{
+		case OptionType::Check:
+			out << "type check default " << default_value;
+			break;
+
+		case OptionType::Spin:
+			out << "type spin default " << default_value << " min " << min << " max " << max;
+			break;
+
+		case OptionType::Combo:
+			out << "type combo default " << default_value;
+			for (const auto& variant : variants)
+			{
+				out << " var " << variant;
+			}
+			break;
+
+		case OptionType::String:
+			out << "type string default " << (default_value.empty() ? "<empty>" : default_value);
+			break;
+		}
+	}
+
+	void Registry::add(const std::string& name, const Option& option)
+	{
+		assert(index_of(name) < 0);
+		options.emplace_back(name, option);
+	}
+
+	void Registry::print(std::ostream& out) const
+	{
+		for (const auto& option : options)
+		{
+			out << "option name " << option.first << " ";
+			option.second.print(out);
+			out << std::endl;
+		}
+	}
+
+	bool Registry::set(const std::string& name, const std::string& value)
+	{
+		const int index = index_of(name);
+		return index >= 0 && options[index].second.set(value);
+	}
+
+	const Option& Registry::operator[](const std::string& name) const
+	{
+		const int index = index_of(name);
+		assert(index >= 0);
+		return options[index].second;
+	}
+
+	int Registry::index_of(const std::string& name) const
+	{
+		for (std::size_t i = 0; i < options.size(); i++)
+		{
+			if (equal_ignoring_case(options[i].first, name))
+			{
+				return int(i);
+			}
+		}
+		return -1;
+	}
+}
@@ -0,0 +1,106 @@
+/*
+* author: Himangshu Saikia, 2018-2021
+* email : himangshu.saikia.iitg@gmail.com
+*/
+
+#pragma once
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace UciOptions
+{
+	/// The option types of the UCI protocol in use by the engine
+	enum class OptionType
+	{
+		Check,	///< a boolean, true or false
+		Spin,	///< an integer within a range
+		Combo,	///< one of a fixed set of strings
+		String	///< any string, <empty> stands for the empty string
+	};
+
+	/// A typed engine setting which the GUI can change with setoption. The value is
+	/// checked against the type, and the engine is told about every accepted change.
+	class Option
+	{
+	public:
+		/// Called with the option after its value has changed
+		using OnChange = std::function<void(const Option&)>;
+
+		/// A check option
+		Option(bool default_value, OnChange on_change = nullptr);
+
+		/// A spin option
+		/// @param[in] default_value The initial value
+		/// @param[in] min The lowest value allowed
+		/// @param[in] max The highest value allowed
+		Option(int default_value, int min, int max, OnChange on_change = nullptr);
+
+		/// A combo option
+		/// @param[in] default_value The initial value, one of the variants
+		/// @param[in] variants All values allowed
+		Option(const std::string& default_value, const std::vector<std::string>& variants, OnChange on_change = nullptr);
+
+		/// A string option
+		Option(const std::string& default_value, OnChange on_change = nullptr);
+		Option(const char* default_value, OnChange on_change = nullptr);
+
+		/// Sets the value received from the GUI. A spin value is clamped to its range.
+		/// @param[in] value The value as sent by setoption
+		/// @return true if the value was valid for the type, false otherwise
+		bool set(const std::string& value);
+
+		/// @return the value of a check option
+		bool as_bool() const;
+
+		/// @return the value of a spin option
+		int as_int() const;
+
+		/// @return the value of a combo or string option
+		const std::string& as_string() const;
+
+		/// Writes the type, the default and the range of the option, as in the option command
+		void print(std::ostream& out) const;
+
+	private:
+		OptionType type;
+		std::string default_value;
+		std::string value;
+		int min = 0;
+		int max = 0;
+		std::vector<std::string> variants;
+		OnChange on_change;
+	};
+
+	/// The options of the engine in the order they are announced to the GUI.
+	/// Names are matched without regard to case, as the protocol requires.
+	class Registry
+	{
+	public:
+		/// Adds an option. Its initial value is not passed to the engine, so the
+		/// default must match the engine's own default.
+		/// @param[in] name The name shown by the GUI, it may contain spaces
+		/// @param[in] option The option
+		void add(const std::string& name, const Option& option);
+
+		/// Writes one option line per option, as the answer to the uci command
+		void print(std::ostream& out) const;
+
+		/// Applies a setoption command
+		/// @param[in] name The name of the option
+		/// @param[in] value The new value
+		/// @return false if the option does not exist or the value is invalid
+		bool set(const std::string& name, const std::string& value);
+
+		/// @return the option of the given name, which must exist
+		const Option& operator[](const std::string& name) const;
+
+	private:
+		/// @return the position of the option in the list, -1 if there is none
+		int index_of(const std::string& name) const;
+
+		std::vector<std::pair<std::string, Option>> options;
+	};
+}
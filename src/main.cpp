@@ -5,6 +5,11 @@
 
 #include "Xewali/ab_id_engine.h"
 #include "Xewali/evaluation.h"
+#include "Xewali/time_manager.h"
+#include "Xewali/transposition.h"
+#include "Xewali/uci_options.h"
+#include <atomic>
+#include <cstdlib>
 #include <ctime>
 #include <sstream>
 #include <iostream>
@@ -21,17 +26,78 @@ void tokenize(std::string line, std::vector<std::string>& tokens)
 	}
 }
 
+/// Registers the options the GUI can change. The defaults are the ones the engine
+/// starts with, every change is applied to the engine at once.
+/// @param[out] options The registry
+/// @param[in] book The opening book, reloaded when the book file changes
+void init_options(UciOptions::Registry& options, Evaluation::Book& book)
+{
+	using UciOptions::Option;
+	using AbIterDeepEngine::Pruning;
+
+	options.add("Hash", Option(int(Transposition::DefaultSizeMB), 1, int(Transposition::MaxSizeMB), [](const Option& o)
+	{
+		AbIterDeepEngine::set_hash_size(std::size_t(o.as_int()));
+	}));
+	options.add("Threads", Option(1, 1, AbIterDeepEngine::MaxThreads, [](const Option& o)
+	{
+		AbIterDeepEngine::set_threads(o.as_int());
+	}));
+	options.add("MultiPV", Option(1, 1, AbIterDeepEngine::MaxMultiPV, [](const Option& o)
+	{
+		AbIterDeepEngine::set_multi_pv(o.as_int());
+	}));
+	options.add("Move Overhead", Option(TimeManagement::DefaultMoveOverhead, 0, 5000, [](const Option& o)
+	{
+		AbIterDeepEngine::set_move_overhead(o.as_int());
+	}));
+	options.add("BookFile", Option("./engines/uci_games.txt", [&book](const Option& o)
+	{
+		book.clear();
+		if (!o.as_string().empty())
+		{
+			Evaluation::load_games(book, o.as_string());
+		}
+	}));
+	// the GUI only tells whether it will send go ponder, the search needs no setting
+	options.add("Ponder", Option(false));
+	options.add("SMP Mode", Option("LazySMP", { "LazySMP", "YBWC" }, [](const Option& o)
+	{
+		AbIterDeepEngine::set_smp_mode(o.as_string() == "YBWC" ? AbIterDeepEngine::SmpMode::YBWC : AbIterDeepEngine::SmpMode::LazySMP);
+	}));
+	options.add("Late Move Reductions", Option(true, [](const Option& o)
+	{
+		AbIterDeepEngine::set_pruning(Pruning::LateMoveReductions, o.as_bool());
+	}));
+	options.add("Futility Pruning", Option(true, [](const Option& o)
+	{
+		AbIterDeepEngine::set_pruning(Pruning::Futility, o.as_bool());
+	}));
+	options.add("Razoring", Option(true, [](const Option& o)
+	{
+		AbIterDeepEngine::set_pruning(Pruning::Razoring, o.as_bool());
+	}));
+	options.add("Late Move Pruning", Option(true, [](const Option& o)
+	{
+		AbIterDeepEngine::set_pruning(Pruning::LateMovePruning, o.as_bool());
+	}));
+}
+
 int ucimain()
 {
 	// initializes the bitboards
 	AbIterDeepEngine::init();
 
-	// load the book moves
 	Evaluation::Book book;
-	Evaluation::load_games(book, "./engines/uci_games.txt");
+	UciOptions::Registry options;
+	init_options(options, book);
+
+	// load the book moves
+	Evaluation::load_games(book, options["BookFile"].as_string());
 
 	Position pos;
-	double currentEvaluation = 0.;
+	// written by the search thread once a search has ended
+	std::atomic<Value> currentEvaluation(VALUE_DRAW);
 	std::string line;
 	while (getline(std::cin, line))
 	{
@@ -46,18 +112,46 @@ int ucimain()
 
 		if (tokens[0] == "uci")
 		{
-			std::cout << "id name Xewali 1.0" << std::endl;
-			std::cout << "id author Himangshu Saikia" << std::endl;
-			std::cout << "uciok" << std::endl;
+			// the reply is sent at once, so that it is never interleaved with the output of a search
+			std::ostringstream reply;
+			reply << "id name Xewali 1.0" << std::endl;
+			reply << "id author Himangshu Saikia" << std::endl;
+			options.print(reply);
+			reply << "uciok";
+			AbIterDeepEngine::send(reply.str());
 		}
 		else if (tokens[0] == "ucinewgame")
 		{
-			// nothing to init
+			AbIterDeepEngine::wait_for_search();
 			// std::cout << "echo Book is loaded with " << book.size() << " positions\n";
+			AbIterDeepEngine::new_game();
+		}
+		else if (tokens[0] == "setoption")
+		{
+			AbIterDeepEngine::wait_for_search();
+			// setoption name <name> [value <value>], names may contain spaces
+			std::string name = "";
+			std::string value = "";
+			bool reading_name = true;
+			for (int i = 2; i < tokens.size(); i++)
+			{
+				if (tokens[i] == "value")
+				{
+					reading_name = false;
+					continue;
+				}
+				std::string& field = reading_name ? name : value;
+				field += field.empty() ? tokens[i] : " " + tokens[i];
+			}
+
+			if (!options.set(name, value))
+			{
+				AbIterDeepEngine::send("info string unknown option or invalid value: " + name);
+			}
 		}
 		else if (tokens[0] == "isready")
 		{
-			std::cout << "readyok" << std::endl;
+			AbIterDeepEngine::send("readyok");
 		}
 		else if (tokens[0] == "position")
 		{
@@ -95,34 +189,125 @@ int ucimain()
 		}
 		else if (tokens[0] == "go")
 		{
-			double time_to_move = 1.0;
-			if (tokens.size() == 9 && tokens[1] == "wtime" && tokens[3] == "btime" && tokens[5] == "winc" && tokens[7] == "binc")
+			// go [wtime <ms>] [btime <ms>] [winc <ms>] [binc <ms>] [movestogo <n>] [movetime <ms>]
+			//    [depth <plies>] [nodes <n>] [mate <moves>] [infinite] [ponder] [searchmoves <move> ...]
+			AbIterDeepEngine::SearchLimits limits;
+			for (int i = 1; i < tokens.size(); i++)
 			{
-				const auto wtime = std::atoi(tokens[2].c_str());
-				const auto btime = std::atoi(tokens[4].c_str());
-				const auto winc = std::atoi(tokens[6].c_str());
-				const auto binc = std::atoi(tokens[8].c_str());
+				if (tokens[i] == "infinite")
+				{
+					limits.infinite = true;
+					continue;
+				}
+				if (tokens[i] == "ponder")
+				{
+					limits.ponder = true;
+					continue;
+				}
+				if (tokens[i] == "searchmoves")
+				{
+					// the moves run up to the next token which is not a legal move
+					Move move;
+					while (i + 1 < tokens.size() && (move = safe_move_from_string(pos, tokens[i + 1])) != MOVE_NONE)
+					{
+						limits.search_moves.push_back(move);
+						i++;
+					}
+					continue;
+				}
+				if (i + 1 >= tokens.size())
+				{
+					break;
+				}
+				const int value = std::atoi(tokens[i + 1].c_str());
+				if (tokens[i] == "wtime")
+				{
+					limits.time[Color::WHITE] = value;
+				}
+				else if (tokens[i] == "btime")
+				{
+					limits.time[Color::BLACK] = value;
+				}
+				else if (tokens[i] == "winc")
+				{
+					limits.increment[Color::WHITE] = value;
+				}
+				else if (tokens[i] == "binc")
+				{
+					limits.increment[Color::BLACK] = value;
+				}
+				else if (tokens[i] == "movestogo")
+				{
+					limits.moves_to_go = value;
+				}
+				else if (tokens[i] == "movetime")
+				{
+					limits.move_time = value;
+				}
+				else if (tokens[i] == "depth")
+				{
+					limits.depth = value;
+				}
+				else if (tokens[i] == "nodes")
+				{
+					limits.nodes = std::strtoull(tokens[i + 1].c_str(), nullptr, 10);
+				}
+				else if (tokens[i] == "mate")
+				{
+					limits.mate = value;
+				}
+				else
+				{
+					continue;
+				}
+				i++;
+			}
 
-				time_to_move = pos.side_to_move() == Color::WHITE ? (wtime + winc) / 60000.0 : (btime + binc) / 60000.0;
+			// without a clock or any other limit the engine thinks for a second
+			if (limits.time[pos.side_to_move()] == 0 && limits.move_time == 0 && !limits.infinite
+				&& limits.depth == 0 && limits.nodes == 0 && limits.mate == 0)
+			{
+				limits.move_time = 1000;
 			}
-			time_to_move = time_to_move > 5.0 ? 5.0 : time_to_move;
+
 			//pos.print();
-			std::cout << "info Thinking..." << std::endl;
-			std::cout << "bestmove " << AbIterDeepEngine::play_move(pos, currentEvaluation, book, time_to_move) << std::endl;
+			AbIterDeepEngine::start_search(pos, book, limits, [&currentEvaluation](const std::string& best_move, const std::string& ponder, Value eval)
+			{
+				currentEvaluation = eval;
+				AbIterDeepEngine::send("bestmove " + best_move + (ponder.empty() ? "" : " ponder " + ponder));
+			});
+		}
+		else if (tokens[0] == "ponderhit")
+		{
+			AbIterDeepEngine::ponderhit();
+		}
+		else if (tokens[0] == "stop")
+		{
+			AbIterDeepEngine::stop();
 		}
 		else if (tokens[0] == "quit")
 		{
 			break;
 		}
+		else if (tokens[0] == "bench")
+		{
+			AbIterDeepEngine::wait_for_search();
+			// bench [depth]
+			AbIterDeepEngine::bench(tokens.size() > 1 ? std::atoi(tokens[1].c_str()) : 6);
+		}
 		else if (tokens[0] == "eval")
 		{
-			std::cout << currentEvaluation << std::endl;
+			AbIterDeepEngine::send(std::to_string(int(currentEvaluation)));
 		}
 		else
 		{
 			//nothing to do
 		}
 	}
+
+	// quit or the end of the input stops a running search
+	AbIterDeepEngine::stop();
+	AbIterDeepEngine::wait_for_search();
 	return 0;
 }
 